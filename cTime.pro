@@ -1,13 +1,31 @@
 TEMPLATE = app
-CONFIG += console c++17
+CONFIG += console c++17 thread
 CONFIG -= app_bundle
 CONFIG -= qt
 
 SOURCES += \
     src/LibOb/CommonCpp/LibOb_strptime.c \
+    src/benchmark.cpp \
     src/main.cpp \
     src/LibCpp/Time/cTimeStd.cpp \
+    src/LibCpp/Time/cTimeClock.cpp \
+    src/LibCpp/Time/cTimeColumns.cpp \
+    src/LibCpp/Time/cTimeScan.cpp \
+    src/LibCpp/Time/cLogTimes.cpp \
+    src/LibCpp/Time/cZoneInfo.cpp \
+    src/LibCpp/Time/cZoneRule.cpp \
+    src/LibCpp/Time/cPackedTime.cpp \
+    src/LibCpp/Time/cZonedTime.cpp \
 
 HEADERS += \
+    src/benchmark.h \
+    src/LibCpp/Time/cCalendarMath.h \
+    src/LibCpp/Time/cCalendarView.h \
+    src/LibCpp/Time/cLogTimes.h \
+    src/LibCpp/Time/cPackedTime.h \
     src/LibCpp/Time/cTime.h \
+    src/LibCpp/Time/cTimeFormat.h \
+    src/LibCpp/Time/cZoneInfo.h \
+    src/LibCpp/Time/cZoneRule.h \
+    src/LibCpp/Time/cZonedTime.h \
     src/LibOb/CommonCpp/LibOb_strptime.h
@@ -0,0 +1,291 @@
+// utf-8 (ü)
+/**
+ * @file   cCalendarMath.h
+ * @author Olaf Simon
+ * @brief  Header only, constexpr calendar arithmetic of class LibCpp::cTime
+ *
+ * \addtogroup LibCpp_time
+ * @{
+ *
+ * The conversions between unix time and calendar data within a fixed zone are pure integer
+ * arithmetic (the same block arithmetic as used by y2038Calendar.cpp). The functions of this
+ * header are constexpr, thus constant time stamps are calculated by the compiler and run time
+ * calls are inlined completely. cTime::daysFromCivil(), cTime::civilFromDays(),
+ * cTime::unixToCalendar() and cTime::calendarToUnix() use these functions.
+ * \code
+ * constexpr time_t y2038 = LibCpp::calendarMath::unixTime(2038, 1, 19, 3, 14, 8);
+ * static_assert(y2038 == 0x80000000ll, "y2038");
+ *
+ * constexpr stCalendar newYear = LibCpp::calendarMath::unixToCalendar(1704067200, {1, 0}, 0);
+ * static_assert(newYear.hour == 1 && newYear.dayInWeek == 1, "CET");
+ * \endcode
+ * The local time zone is not known at compile time, the functions always use the zone and dst given
+ * (see cTime::zoneOffset).
+**/
+
+#ifndef cCalendarMath_H
+#define cCalendarMath_H
+
+#include "cTime.h"
+
+#define LibCpp_SECONDSPERMINUTE 60      ///< Konstante
+#define LibCpp_SECONDSPERHOUR 3600      ///< Konstante
+#define LibCpp_SECONDSPERDAY 86400      ///< Konstante
+#define LibCpp_NANOSECONDSPERSECOND 1000000000   ///< Konstante
+
+/** Leap year rule dependent blocks of days. Each block ends with the year the rule applies to, thus the 400 year block starts with 1.1.2001 **/
+#define LibCpp_DAYSPERNORMALYEAR 365                                ///< Days of a year without leap day
+#define LibCpp_DAYSPER4YEARS   (4 * LibCpp_DAYSPERNORMALYEAR + 1)   ///< One leap year every 4 years
+#define LibCpp_DAYSPER100YEARS (25 * LibCpp_DAYSPER4YEARS - 1)      ///< No leap year every 100 years
+#define LibCpp_DAYSPER400YEARS (4 * LibCpp_DAYSPER100YEARS + 1)     ///< Remaining leap year every 400 years
+#define LibCpp_DAYS1970TO2001  11323                                ///< Days from 1.1.1970 till 1.1.2001 (begin of a 400 year block)
+
+namespace LibCpp
+{
+
+namespace calendarMath
+{
+
+/**
+ * Days of the year before the first of a month (index 0 = January), last entry is the length of the year
+ */
+inline constexpr uint16_t DAYSTILLMONTH[2][13] =
+    {{0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365},
+     {0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, 366}};
+
+/**
+ * @brief Integer division rounding towards minus infinity.
+ * The remainder is always positive, thus value = result * divisor + *pRemainder.
+ * @param value
+ * @param divisor Positive divisor.
+ * @param pRemainder Remainder [output]
+ * @return Floored quotient
+ */
+constexpr int64_t floorDivision(int64_t value, int64_t divisor, int64_t* pRemainder)
+{
+    int64_t quotient = value / divisor;
+    int64_t remainder = value % divisor;
+    if (remainder < 0)
+    {
+        remainder += divisor;
+        quotient--;
+    }
+    *pRemainder = remainder;
+    return quotient;
+}
+
+/**
+ * @brief Integer division rounding towards minus infinity.
+ * @param value
+ * @param divisor Positive divisor.
+ * @return Floored quotient
+ */
+constexpr int64_t floorDivision(int64_t value, int64_t divisor)
+{
+    int64_t remainder = 0;
+    return floorDivision(value, divisor, &remainder);
+}
+
+/**
+ * @brief Remainder of the division rounding towards minus infinity.
+ * @param value
+ * @param divisor Positive divisor.
+ * @return Remainder 0 till divisor-1, also for negative values
+ */
+constexpr int64_t floorModulo(int64_t value, int64_t divisor)
+{
+    int64_t remainder = 0;
+    floorDivision(value, divisor, &remainder);
+    return remainder;
+}
+
+/**
+ * @brief Seconds to add to UTC to receive the wall clock time of the given zone and dst.
+ * The minutes of the zone carry the sign of the hours, e.g. {-3, 30} is the zone -03:30.
+ * @param zone Geographic time zone (dst = 0 or 1) or UTC relative time zone (dst = -1).
+ * @param dst
+ * @return Offset in seconds
+ */
+constexpr int32_t zoneOffset(stTimeZone zone, int8_t dst)
+{
+    int32_t offset = (int32_t)zone.minutes * LibCpp_SECONDSPERMINUTE;
+    if (zone.hours < 0) offset = -offset;
+    offset += (int32_t)zone.hours * LibCpp_SECONDSPERHOUR;
+    if (dst > 0) offset += LibCpp_SECONDSPERHOUR;
+    return offset;
+}
+
+/**
+ * @brief Days since 1.1.1970 of a (proleptic gregorian) date.
+ * The date is split into 400, 100 and 4 year blocks beginning with the year 2001 (see y2038Calendar.cpp).
+ * Months outside 1-12 and days beyond the end of the month are carried over like mktime() does.
+ * @param year
+ * @param month 1-12
+ * @param day 1-31
+ * @return Days since 1.1.1970, negative for earlier dates
+ */
+constexpr int64_t daysFromCivil(int32_t year, int64_t month, int64_t day)
+{
+    int64_t monthIndex = 0;
+    int64_t y = floorDivision(month - 1, 12, &monthIndex) + year;
+    int64_t rem = 0;
+    int64_t k = floorDivision(y - 2001, 400, &rem);
+    int64_t j = rem / 100;
+    rem = rem % 100;
+    int64_t i = rem / 4;
+    int64_t h = rem % 4;
+    int leap = LibOb_isLeapYear(y);
+    return LibCpp_DAYS1970TO2001 + k * LibCpp_DAYSPER400YEARS + j * LibCpp_DAYSPER100YEARS + i * LibCpp_DAYSPER4YEARS + h * LibCpp_DAYSPERNORMALYEAR
+           + DAYSTILLMONTH[leap][monthIndex] + day - 1;
+}
+
+/**
+ * @brief Date of the given days since 1.1.1970.
+ * Inverse of daysFromCivil().
+ * @param days Days since 1.1.1970
+ * @param pYear [output]
+ * @param pMonth [output] 1-12
+ * @param pDay [output] 1-31
+ * @param pDayInYear [output] 1-366, may be zero
+ */
+constexpr void civilFromDays(int64_t days, int32_t* pYear, uint8_t* pMonth, uint8_t* pDay, uint16_t* pDayInYear = nullptr)
+{
+    int64_t rem = 0;
+    int64_t k = floorDivision(days - LibCpp_DAYS1970TO2001, LibCpp_DAYSPER400YEARS, &rem);
+    int64_t j = rem / LibCpp_DAYSPER100YEARS;
+    if (j == 4) j = 3;      // 31.12. of the leap year closing the 400 year block
+    rem -= j * LibCpp_DAYSPER100YEARS;
+    int64_t i = rem / LibCpp_DAYSPER4YEARS;
+    rem -= i * LibCpp_DAYSPER4YEARS;
+    int64_t h = rem / LibCpp_DAYSPERNORMALYEAR;
+    if (h == 4) h = 3;      // 31.12. of the leap year closing the 4 year block
+    rem -= h * LibCpp_DAYSPERNORMALYEAR;
+
+    int32_t year = (int32_t)(2001 + k * 400 + j * 100 + i * 4 + h);
+    int leap = LibOb_isLeapYear(year);
+    int month = (int)(rem / 32) + 1;    // is either the month or the month before
+    if (rem >= DAYSTILLMONTH[leap][month]) month++;
+
+    *pYear  = year;
+    *pMonth = (uint8_t)month;
+    *pDay   = (uint8_t)(rem - DAYSTILLMONTH[leap][month - 1] + 1);
+    if (pDayInYear) *pDayInYear = (uint16_t)(rem + 1);
+}
+
+/**
+ * @brief Day of the week of the given days since 1.1.1970.
+ * @param days Days since 1.1.1970
+ * @return 1-7 as 1 for monday
+ */
+constexpr uint8_t dayInWeek(int64_t days)
+{
+    return (uint8_t)(floorModulo(days + 3, 7) + 1);    // 1.1.1970 was a thursday
+}
+
+/**
+ * @brief Calendar data of a unix time at the given UTC offset, labelled with the given zone and dst.
+ * The date and time fields are computed from utcOffset only. The zone and dst are stored as they are,
+ * they are not required to match utcOffset (e.g. a label of minute resolution for an offset with seconds).
+ * @param unixTime
+ * @param utcOffset Seconds to add to UTC to receive the wall clock time
+ * @param zone Zone stored to the calendar
+ * @param dst Dst stored to the calendar
+ * @return calendar struct
+ */
+constexpr stCalendar unixToCalendar(time_t unixTime, int32_t utcOffset, stTimeZone zone, int8_t dst)
+{
+    stCalendar calendar = {};
+    int64_t second = 0;
+    int64_t days = floorDivision((int64_t)unixTime + utcOffset, LibCpp_SECONDSPERDAY, &second);
+    civilFromDays(days, &calendar.year, &calendar.month, &calendar.day, &calendar.dayInYear);
+    calendar.hour      = (uint8_t)(second / LibCpp_SECONDSPERHOUR);
+    second            %= LibCpp_SECONDSPERHOUR;
+    calendar.minute    = (uint8_t)(second / LibCpp_SECONDSPERMINUTE);
+    calendar.second    = (uint8_t)(second % LibCpp_SECONDSPERMINUTE);
+    calendar.dayInWeek = dayInWeek(days);
+    calendar.dst       = dst;
+    calendar.timeZone  = zone;
+    return calendar;
+}
+
+/**
+ * @brief Calendar data of a unix time within a fixed zone.
+ * The zone and dst are used as given, see \ref zoneOffset.
+ * @param unixTime
+ * @param zone Geographic time zone (dst = 0 or 1) or UTC relative time zone (dst = -1).
+ * @param dst
+ * @return calendar struct
+ */
+constexpr stCalendar unixToCalendar(time_t unixTime, stTimeZone zone = stTimeZone{0, 0}, int8_t dst = -1)
+{
+    return unixToCalendar(unixTime, zoneOffset(zone, dst), zone, dst);
+}
+
+/**
+ * @brief Zone label of an UTC offset.
+ * The label has minute resolution and its minutes carry the sign of the hours (see \ref zoneOffset),
+ * thus seconds are dropped and offsets between -1 hour and 0 are labelled with a positive offset
+ * (e.g. -00:44:30 is labelled {0, 44}). Only the label is affected, see offsetToCalendar().
+ * @param utcOffset Seconds to add to UTC
+ * @return Zone with hours and minutes truncated towards zero
+ */
+constexpr stTimeZone offsetZone(int32_t utcOffset)
+{
+    int32_t minutes = (utcOffset % LibCpp_SECONDSPERHOUR) / LibCpp_SECONDSPERMINUTE;
+    return stTimeZone{(int8_t)(utcOffset / LibCpp_SECONDSPERHOUR), (uint8_t)(minutes < 0 ? -minutes : minutes)};
+}
+
+/**
+ * @brief Calendar data of a unix time at the UTC offset of a zone rule or a zone of the time zone data base.
+ * The date and time fields are computed from the full utcOffset, thus the wall clock time is exact for any offset.
+ * The calendar is labelled with the geographic (standard time) zone and the dst, as cTime::calendar() does for
+ * the local zone. The label takes daylight saving time as one hour ahead of the standard time and is reduced to
+ * the resolution of stTimeZone (see offsetZone()), thus it only approximates offsets with seconds, offsets
+ * between -1 hour and 0 (e.g. the local mean times of Monrovia, Dublin or Lisbon) and dst shifts other than one hour.
+ * @param unixTime
+ * @param utcOffset Seconds to add to UTC to receive the wall clock time
+ * @param dst 1 = daylight saving time, 0 = standard time
+ * @return calendar struct
+ */
+constexpr stCalendar offsetToCalendar(time_t unixTime, int32_t utcOffset, int8_t dst)
+{
+    return unixToCalendar(unixTime, utcOffset, offsetZone(dst > 0 ? utcOffset - LibCpp_SECONDSPERHOUR : utcOffset), dst);
+}
+
+/**
+ * @brief Unix time of the given wall clock time within a fixed zone.
+ * Entries exceeding their range are carried over like mktime() does.
+ * @param year
+ * @param month 1-12
+ * @param day 1-31
+ * @param hour 0-23
+ * @param minute 0-59
+ * @param second 0-59
+ * @param zone Geographic time zone (dst = 0 or 1) or UTC relative time zone (dst = -1).
+ * @param dst
+ * @return unix time
+ */
+constexpr time_t unixTime(int32_t year, int64_t month, int64_t day, int64_t hour = 0, int64_t minute = 0, int64_t second = 0, stTimeZone zone = stTimeZone{0, 0}, int8_t dst = -1)
+{
+    int64_t value = daysFromCivil(year, month, day) * LibCpp_SECONDSPERDAY + hour * LibCpp_SECONDSPERHOUR + minute * LibCpp_SECONDSPERMINUTE + second;
+    return (time_t)(value - zoneOffset(zone, dst));
+}
+
+/**
+ * @brief Unix time of calendar data carrying a valid zone.
+ * Inverse of unixToCalendar(). Entries exceeding their range are carried over like mktime() does.
+ * @param calendar Calendar data, the time zone must be valid. An invalid dst is treated as UTC relative zone.
+ * @return unix time
+ */
+constexpr time_t calendarToUnix(const stCalendar& calendar)
+{
+    return unixTime(calendar.year, calendar.month, calendar.day, calendar.hour, calendar.minute, calendar.second, calendar.timeZone, calendar.dst);
+}
+
+}
+
+}
+
+#endif // cCalendarMath_H
+
+/** @} */
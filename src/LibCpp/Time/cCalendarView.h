@@ -0,0 +1,139 @@
+// utf-8 (ü)
+/**
+ * @file   cCalendarView.h
+ * @author Olaf Simon
+ * @brief  Header only, class LibCpp::cCalendarView
+ *
+ * \addtogroup LibCpp_time
+ * @{
+ *
+ * cTime::calendar() calculates all entries of a stCalendar although most callers need one or two of
+ * them, e.g. the year or the hour for bucketing. A calendar view holds the wall clock time of an instant
+ * after resolving the zone once and calculates an entry when it is asked for:
+ * - hour(), minute(), second() and dayInWeek() are a division of the wall clock seconds.
+ * - year(), month(), day() and dayInYear() calculate the date once (calendarMath::civilFromDays)
+ *   and memorize it for the other date entries.
+ * \code
+ * cCalendarView view = cTime::now().view();
+ * if (view.hour() < 6) buckets[view.dayInWeek()]++;
+ * int32_t year = cTime::now().year();     // single entry, same as calendar().year
+ * \endcode
+**/
+
+#ifndef cCalendarView_H
+#define cCalendarView_H
+
+#include "cTime.h"
+#include "cCalendarMath.h"
+
+namespace LibCpp
+{
+
+/**
+ * @brief Calendar data of an instant within a fixed zone, calculated per entry when asked for.
+ * The entries are equal to those of calendarMath::unixToCalendar() for the same zone and dst.
+**/
+class cCalendarView
+{
+public:
+    cCalendarView(time_t unixTime = 0, stTimeZone zone = stTimeZone{0, 0}, int8_t dst = -1, uint32_t nanoSeconds = 0); ///< Constructor, resolves the wall clock time of the zone.
+    cCalendarView(time_t unixTime, int32_t utcOffset, stTimeZone zone, int8_t dst, uint32_t nanoSeconds = 0);          ///< Constructor, resolves the wall clock time of the UTC offset, zone and dst are the label.
+
+    int32_t  year()      { date(); return _year; }                                                              ///< Year.
+    uint8_t  month()     { date(); return _month; }                                                             ///< Month 1-12.
+    uint8_t  day()       { date(); return _day; }                                                               ///< Day 1-31.
+    uint16_t dayInYear() { date(); return _dayInYear; }                                                         ///< Day 1-366 as 1 for the 1st of January.
+    uint8_t  hour() const      { return (uint8_t)(_secondOfDay / LibCpp_SECONDSPERHOUR); }                      ///< Hour 0-23.
+    uint8_t  minute() const    { return (uint8_t)(_secondOfDay % LibCpp_SECONDSPERHOUR / LibCpp_SECONDSPERMINUTE); } ///< Minute 0-59.
+    uint8_t  second() const    { return (uint8_t)(_secondOfDay % LibCpp_SECONDSPERMINUTE); }                    ///< Second 0-59.
+    uint8_t  dayInWeek() const { return calendarMath::dayInWeek(_days); }                                       ///< Day 1-7 as 1 for monday.
+    int64_t  days() const      { return _days; }                                                                ///< Days since 1.1.1970 of the wall clock date.
+    stCalendar calendar();      ///< All entries as calendar struct.
+
+private:
+    void date();                ///< Calculates the date entries once.
+
+    int64_t    _days;           ///< Days since 1.1.1970 of the wall clock time
+    int32_t    _secondOfDay;    ///< Seconds after midnight of the wall clock time
+    stTimeZone _zone;           ///< Zone as given
+    int8_t     _dst;            ///< Daylight saving time as given
+    bool       _dateValid;      ///< The date entries are calculated
+    uint32_t   _nanoSeconds;    ///< Nano seconds after the second
+    int32_t    _year;           ///< Year, valid if _dateValid
+    uint8_t    _month;          ///< Month, valid if _dateValid
+    uint8_t    _day;            ///< Day, valid if _dateValid
+    uint16_t   _dayInYear;      ///< Day in the year, valid if _dateValid
+};
+
+/**
+ * @brief Constructor, resolves the wall clock time of the zone.
+ * @param unixTime
+ * @param zone Geographic time zone (dst = 0 or 1) or UTC relative time zone (dst = -1).
+ * @param dst
+ * @param nanoSeconds Nano seconds after the second, passed to calendar()
+ */
+inline cCalendarView::cCalendarView(time_t unixTime, stTimeZone zone, int8_t dst, uint32_t nanoSeconds)
+    : cCalendarView(unixTime, calendarMath::zoneOffset(zone, dst), zone, dst, nanoSeconds)
+{
+}
+
+/**
+ * @brief Constructor, resolves the wall clock time of the UTC offset.
+ * The entries are equal to those of calendarMath::unixToCalendar(unixTime, utcOffset, zone, dst).
+ * @param unixTime
+ * @param utcOffset Seconds to add to UTC to receive the wall clock time
+ * @param zone Zone passed to calendar()
+ * @param dst Dst passed to calendar()
+ * @param nanoSeconds Nano seconds after the second, passed to calendar()
+ */
+inline cCalendarView::cCalendarView(time_t unixTime, int32_t utcOffset, stTimeZone zone, int8_t dst, uint32_t nanoSeconds)
+{
+    int64_t second = 0;
+    _days = calendarMath::floorDivision((int64_t)unixTime + utcOffset, LibCpp_SECONDSPERDAY, &second);
+    _secondOfDay = (int32_t)second;
+    _zone = zone;
+    _dst = dst;
+    _dateValid = false;
+    _nanoSeconds = nanoSeconds;
+    _year = 0;
+    _month = 0;
+    _day = 0;
+    _dayInYear = 0;
+}
+
+/**
+ * @brief Calculates the date entries once.
+ */
+inline void cCalendarView::date()
+{
+    if (_dateValid) return;
+    calendarMath::civilFromDays(_days, &_year, &_month, &_day, &_dayInYear);
+    _dateValid = true;
+}
+
+/**
+ * @brief All entries as calendar struct, equal to cTime::calendar() of the same zone.
+ * @return calendar struct
+ */
+inline stCalendar cCalendarView::calendar()
+{
+    date();
+    stCalendar calendar = {};
+    calendar.year        = _year;
+    calendar.month       = _month;
+    calendar.day         = _day;
+    calendar.hour        = hour();
+    calendar.minute      = minute();
+    calendar.second      = second();
+    calendar.dst         = _dst;
+    calendar.timeZone    = _zone;
+    calendar.nanoSeconds = _nanoSeconds;
+    calendar.dayInYear   = _dayInYear;
+    calendar.dayInWeek   = dayInWeek();
+    return calendar;
+}
+
+}
+#endif // cCalendarView_H
+
+/** @} */
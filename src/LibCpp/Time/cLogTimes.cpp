@@ -0,0 +1,329 @@
+// utf-8 (ü)
+
+// MIT License
+// Copyright © 2023 Olaf Simon
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+/**
+ * @file   cLogTimes.cpp
+ * @author Olaf Simon
+ * @brief  Time stamp extraction of (large) log files of class LibCpp::cLogTimes
+ *
+ * \addtogroup LibCpp_time
+ * @{
+ *
+ * The file is mapped into memory (mmap, MapViewOfFile on Windows), thus it is neither copied nor
+ * read line by line. It is split into chunks at line boundaries. The threads take the chunks from a
+ * shared queue and parse the time stamp at the beginning of each line in place with a compiled format
+ * (see LibOb_strnptimeProgram). The parsed calendar data is converted to unix time arithmetically
+ * (see cCalendarMath.h), thus no system time function is called.
+ *
+ * \code
+ * cLogTimes log;
+ * if (log.open("server.log"))
+ * {
+ *     stLogExtraction run = log.extract("%Y-%m-%d %H:%M:%S %Z");
+ *     printf("%.2f GB/s\n", run.bytes / run.seconds * 1e-9);
+ *     // log.times()[i] is the unix time of the line beginning at log.offsets()[i]
+ * }
+ * \endcode
+ *
+ * Lines without time zone information are interpreted within the zone and dst given to cLogTimes::extract (UTC by default).
+**/
+
+#include "cLogTimes.h"
+#include "cCalendarMath.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace LibCpp;
+
+#define LibCpp_LOGCHUNKSPERTHREAD 8         ///< Chunks per thread, balances lines of different costs
+#define LibCpp_LOGMINIMUMCHUNK    (1<<20)   ///< Minimum size of a chunk in bytes
+
+const stLogExtraction LibCpp::stLogExtraction_Ini = {0, 0, 0, 0.0, 0};    ///< Initializer for stLogExtraction
+
+/**
+ * @brief Time stamps of one chunk of lines.
+**/
+typedef struct _stLogChunk
+{
+    std::vector<int64_t>  times;        ///< Unix time of each line
+    std::vector<uint64_t> offsets;      ///< Byte offset of each line
+    uint64_t              invalidLines; ///< Number of lines without time stamp
+} stLogChunk;
+
+/**
+ * @brief Parses the time stamp at the beginning of a line.
+ * @param line First character of the line.
+ * @param length Length of the line without line feed.
+ * @param pProgram Compiled format.
+ * @param zone Time zone of time stamps without zone information.
+ * @param dst dst of time stamps without dst information.
+ * @return Unix time, INT64_INVALID if year, month or day are not found.
+ */
+static int64_t lineTime(const char* line, size_t length, const stFormatProgram* pProgram, stTimeZone zone, int8_t dst)
+{
+    struct tm tmLine;
+    stTimeZone lineZone;
+    LibOb_strnptimeProgram(line, length, pProgram, &tmLine, &lineZone);
+    if (tmLine.tm_year == INT_INVALID || tmLine.tm_mon == INT_INVALID || tmLine.tm_mday == INT_INVALID)
+        return INT64_INVALID;
+    if (lineZone.hours == INT8_INVALID)
+        lineZone = zone;
+    if (tmLine.tm_isdst != INT_INVALID)
+        dst = (int8_t)tmLine.tm_isdst;
+    return calendarMath::unixTime(tmLine.tm_year + 1900, tmLine.tm_mon + 1, tmLine.tm_mday,
+                                  (tmLine.tm_hour == INT_INVALID) ? 0 : tmLine.tm_hour,
+                                  (tmLine.tm_min == INT_INVALID) ? 0 : tmLine.tm_min,
+                                  (tmLine.tm_sec == INT_INVALID) ? 0 : tmLine.tm_sec, lineZone, dst);
+}
+
+/**
+ * @brief Parses all lines of a chunk.
+ * @param data Content of the file.
+ * @param begin Offset of the first line of the chunk.
+ * @param end Offset behind the last line of the chunk.
+ * @param pProgram Compiled format.
+ * @param zone Time zone of time stamps without zone information.
+ * @param dst dst of time stamps without dst information.
+ * @param pChunk Results.
+ */
+static void parseChunk(const char* data, size_t begin, size_t end, const stFormatProgram* pProgram, stTimeZone zone, int8_t dst, stLogChunk* pChunk)
+{
+    size_t position = begin;
+    while (position < end)
+    {
+        const char* line = data + position;
+        const char* lineFeed = (const char*)memchr(line, '\n', end - position);
+        size_t length = lineFeed ? (size_t)(lineFeed - line) : end - position;
+        int64_t time = lineTime(line, length, pProgram, zone, dst);
+        if (time == INT64_INVALID)
+            pChunk->invalidLines++;
+        pChunk->times.push_back(time);
+        pChunk->offsets.push_back(position);
+        position += length + 1;
+    }
+}
+
+/**
+ * @brief Constructor.
+ */
+cLogTimes::cLogTimes() : _data(nullptr), _size(0), _mapping(nullptr), _mappingHandle(nullptr)
+{
+}
+
+/**
+ * @brief Destructor, unmaps the file.
+ */
+cLogTimes::~cLogTimes()
+{
+    close();
+}
+
+/**
+ * @brief Maps a file read only into memory.
+ * @param fileName
+ * @return true on success. An empty file is opened successfully without mapping.
+ */
+bool cLogTimes::open(const std::string& fileName)
+{
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        return false;
+    }
+    if (fileSize.QuadPart > 0)
+    {
+        HANDLE mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* mapping = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!mapping)
+        {
+            if (mappingHandle) CloseHandle(mappingHandle);
+            CloseHandle(file);
+            return false;
+        }
+        _mappingHandle = mappingHandle;
+        _mapping = mapping;
+        _data = (const char*)mapping;
+        _size = (size_t)fileSize.QuadPart;
+    }
+    CloseHandle(file);
+#else
+    int file = ::open(fileName.c_str(), O_RDONLY);
+    if (file < 0) return false;
+    struct stat fileStatus;
+    if (fstat(file, &fileStatus) != 0)
+    {
+        ::close(file);
+        return false;
+    }
+    if (fileStatus.st_size > 0)
+    {
+        void* mapping = mmap(nullptr, (size_t)fileStatus.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(file);
+            return false;
+        }
+        madvise(mapping, (size_t)fileStatus.st_size, MADV_SEQUENTIAL);
+        _mapping = mapping;
+        _data = (const char*)mapping;
+        _size = (size_t)fileStatus.st_size;
+    }
+    ::close(file);
+#endif
+    return true;
+}
+
+/**
+ * @brief Uses a buffer owned by the caller instead of a file.
+ * The buffer has to exist until close() is called or the instance is destroyed.
+ * @param data
+ * @param size
+ * @return true
+ */
+bool cLogTimes::open(const char* data, size_t size)
+{
+    close();
+    _data = data;
+    _size = data ? size : 0;
+    return true;
+}
+
+/**
+ * @brief Unmaps the file and discards the results.
+ */
+void cLogTimes::close()
+{
+#ifdef _WIN32
+    if (_mapping) UnmapViewOfFile(_mapping);
+    if (_mappingHandle) CloseHandle((HANDLE)_mappingHandle);
+#else
+    if (_mapping) munmap(_mapping, _size);
+#endif
+    _mapping = nullptr;
+    _mappingHandle = nullptr;
+    _data = nullptr;
+    _size = 0;
+    _times.clear();
+    _offsets.clear();
+}
+
+/**
+ * @brief Parses the time stamp at the beginning of each line.
+ * The results are available by times() and offsets(), one entry per line (a last line without line feed included).
+ * @param format Format of the time stamps (see \ref TIME_FORMATTING), empty for the \ref GZC default format.
+ * @param threads Number of threads, 0 for the number of hardware threads.
+ * @param zone Time zone of time stamps without zone information.
+ * @param dst dst of time stamps without dst information (see @ref DST dst), UTC relative by default.
+ * @return Statistics of the run. No lines are reported if the format can not be compiled.
+ */
+stLogExtraction cLogTimes::extract(const std::string& format, unsigned int threads, stTimeZone zone, int8_t dst)
+{
+    stLogExtraction result = stLogExtraction_Ini;
+    stFormatProgram program;
+    _times.clear();
+    _offsets.clear();
+    if (!LibOb_compileFormat(&program, format.c_str())) return result;
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    auto start = std::chrono::steady_clock::now();
+
+    // chunks beginning at line boundaries
+    size_t chunkCount = (size_t)threads * LibCpp_LOGCHUNKSPERTHREAD;
+    if (chunkCount > _size / LibCpp_LOGMINIMUMCHUNK) chunkCount = _size / LibCpp_LOGMINIMUMCHUNK;
+    if (chunkCount == 0) chunkCount = 1;
+    if (threads > chunkCount) threads = (unsigned int)chunkCount;
+    std::vector<size_t> bounds(chunkCount + 1, _size);
+    bounds[0] = 0;
+    for (size_t i=1; i<chunkCount; i++)
+    {
+        size_t position = i * (_size / chunkCount);
+        if (position < bounds[i-1]) position = bounds[i-1];
+        if (position > 0 && position < _size)
+        {
+            const char* lineFeed = (const char*)memchr(_data + position - 1, '\n', _size - position + 1);
+            position = lineFeed ? (size_t)(lineFeed - _data) + 1 : _size;
+        }
+        bounds[i] = position;
+    }
+
+    // thread pool working off the chunks
+    std::vector<stLogChunk> chunks(chunkCount);
+    std::atomic<size_t> nextChunk(0);
+    auto worker = [&]()
+    {
+        for (size_t i = nextChunk++; i < chunkCount; i = nextChunk++)
+        {
+            chunks[i].invalidLines = 0;
+            parseChunk(_data, bounds[i], bounds[i+1], &program, zone, dst, &chunks[i]);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned int i=1; i<threads; i++)
+        pool.emplace_back(worker);
+    worker();
+    for (std::thread& thread : pool)
+        thread.join();
+
+    // columns in order of the lines
+    size_t lines = 0;
+    for (const stLogChunk& chunk : chunks)
+    {
+        lines += chunk.times.size();
+        result.invalidLines += chunk.invalidLines;
+    }
+    _times.resize(lines);
+    _offsets.resize(lines);
+    lines = 0;
+    for (const stLogChunk& chunk : chunks)
+    {
+        if (chunk.times.empty()) continue;
+        memcpy(_times.data() + lines, chunk.times.data(), chunk.times.size() * sizeof(int64_t));
+        memcpy(_offsets.data() + lines, chunk.offsets.data(), chunk.offsets.size() * sizeof(uint64_t));
+        lines += chunk.times.size();
+    }
+
+    result.lines = lines;
+    result.bytes = _size;
+    result.threads = threads;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+/** @} */
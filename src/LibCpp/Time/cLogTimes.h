@@ -0,0 +1,73 @@
+// utf-8 (ü)
+/**
+ * @file   cLogTimes.h
+ * @author Olaf Simon
+ * @brief  Class LibCpp::cLogTimes
+ *
+ * \addtogroup LibCpp_time
+ * @{
+**/
+
+#ifndef cLogTimes_H
+#define cLogTimes_H
+
+#include "cTime.h"
+
+#include <string>
+#include <vector>
+
+namespace LibCpp
+{
+
+/**
+ * @brief Statistics of a cLogTimes::extract() run.
+ * Initialize with LibCpp::stLogExtraction_Ini.\n
+**/
+typedef struct _stLogExtraction
+{
+    uint64_t     lines;         ///< Number of lines
+    uint64_t     invalidLines;  ///< Number of lines without time stamp (time set to INT64_INVALID)
+    uint64_t     bytes;         ///< Number of bytes scanned
+    double       seconds;       ///< Duration of the extraction
+    unsigned int threads;       ///< Number of threads used
+} stLogExtraction;
+
+extern const stLogExtraction stLogExtraction_Ini;   ///< stLogExtraction_Ini
+
+/**
+ * @brief Extracts the time stamps of all lines of a (memory mapped) log file.
+ * The file is split at line boundaries into chunks, which are parsed by a pool of threads using a compiled format
+ * (see LibOb_compileFormat). The results are columns of the unix time and the byte offset of each line.
+**/
+class cLogTimes
+{
+public:
+    cLogTimes();                                ///< Constructor.
+    ~cLogTimes();                               ///< Destructor, unmaps the file.
+    cLogTimes(const cLogTimes&) = delete;       ///< Not copyable (holds the mapping).
+    cLogTimes& operator=(const cLogTimes&) = delete;    ///< Not copyable (holds the mapping).
+
+    bool open(const std::string& fileName);     ///< Maps a file read only into memory.
+    bool open(const char* data, size_t size);   ///< Uses a buffer owned by the caller instead of a file.
+    void close();                               ///< Unmaps the file and discards the results.
+
+    stLogExtraction extract(const std::string& format = "", unsigned int threads = 0, stTimeZone zone = stTimeZone_Ini, int8_t dst = -1); ///< Parses the time stamp at the beginning of each line.
+
+    const char*                  data() const    { return _data; }     ///< Mapped content.
+    size_t                       size() const    { return _size; }     ///< Size of the mapped content.
+    const std::vector<int64_t>&  times() const   { return _times; }    ///< Unix time of each line, INT64_INVALID for lines without time stamp.
+    const std::vector<uint64_t>& offsets() const { return _offsets; }  ///< Byte offset of the beginning of each line.
+
+private:
+    const char*           _data;            ///< Content of the file
+    size_t                _size;            ///< Size of the content
+    void*                 _mapping;         ///< Address of the mapping, zero if the content is not mapped by this instance
+    void*                 _mappingHandle;   ///< File mapping object (Windows only)
+    std::vector<int64_t>  _times;           ///< Unix time of each line
+    std::vector<uint64_t> _offsets;         ///< Byte offset of each line
+};
+
+}
+#endif // cLogTimes_H
+
+/** @} */
@@ -0,0 +1,81 @@
+// utf-8 (ü)
+
+// MIT License
+// Copyright © 2023 Olaf Simon
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+/**
+ * @file   cPackedTime.cpp
+ * @author Olaf Simon
+ * @brief  String conversions of class LibCpp::cPackedTime
+ *
+ * \addtogroup LibCpp_time
+ * @{
+ *
+ * A \ref GZC string needs 30 bytes and a stCalendar 24 bytes, a cPackedTime holds the same
+ * information (unix time, dst state and zone) within 8 bytes:
+ * \code
+ * std::vector<int64_t> stamps;
+ * stamps.push_back(cPackedTime::set(cTime::now().time(), cTime::localTimeZone(&dst), dst).value());
+ * std::sort(stamps.begin(), stamps.end());    // chronological order
+ * \endcode
+ * Strings of the fixed GZC layout are scanned by cTime::scanGZC(), any other calendar string is
+ * converted by cTime::fromString().
+**/
+
+#include "cPackedTime.h"
+#include "cTimeFormat.h"
+
+using namespace LibCpp;
+
+/**
+ * @brief Packs a \ref GZC string, e.g. "2023-09-20#17:17:38#DST#+01:00".
+ * Other layouts accepted by cTime::fromString() are packed, if they carry a zone.
+ * @param gzcString
+ * @return Packed time, invalid if the string can not be converted
+ */
+cPackedTime cPackedTime::set(std::string_view gzcString)
+{
+    time_t unixTime;
+    if (gzcString.size() == LibCpp_GZCLENGTH && cTime::scanGZC(gzcString.data(), &unixTime))
+    {   // fixed layout checked by scanGZC: dst code at 20, zone sign at 24, hours at 25 and minutes at 28
+        const char* text = gzcString.data();
+        int8_t dst = (text[20] == 'D') ? 1 : (text[20] == 'S') ? 0 : -1;
+        stTimeZone zone;
+        zone.hours = (int8_t)((text[25] - '0') * 10 + text[26] - '0');
+        zone.minutes = (uint8_t)((text[28] - '0') * 10 + text[29] - '0');
+        if (text[24] == '-') zone.hours = -zone.hours;
+        return set(unixTime, zone, dst);
+    }
+    return set(cTime::fromString(gzcString, ""));
+}
+
+/**
+ * @brief \ref GZC string of the packed time.
+ * @return String, empty if not valid
+ */
+std::string cPackedTime::toString() const
+{
+    if (!isValid()) return std::string();
+    auto gzcFormat = LibCpp_TIMEFORMAT("");
+    char buffer[timeFormat::maxLength<decltype(gzcFormat)> + 1];
+    size_t length = timeFormat::format(buffer, calendar(), gzcFormat);
+    return std::string(buffer, length);
+}
+
+/** @} */
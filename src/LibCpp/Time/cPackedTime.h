@@ -0,0 +1,146 @@
+// utf-8 (ü)
+/**
+ * @file   cPackedTime.h
+ * @author Olaf Simon
+ * @brief  Class LibCpp::cPackedTime
+ *
+ * \addtogroup LibCpp_time
+ * @{
+**/
+
+#ifndef cPackedTime_H
+#define cPackedTime_H
+
+#include "cTime.h"
+#include "cCalendarMath.h"
+
+#include <string>
+#include <string_view>
+
+namespace LibCpp
+{
+
+#define LibCpp_PACKEDTIME_ZONEBITS   7                      ///< Bits of the time zone in quarter hours
+#define LibCpp_PACKEDTIME_DSTBITS    2                      ///< Bits of the dst state
+#define LibCpp_PACKEDTIME_TIMESHIFT  (LibCpp_PACKEDTIME_ZONEBITS + LibCpp_PACKEDTIME_DSTBITS)  ///< Position of the unix time
+#define LibCpp_PACKEDTIME_ZONEBIAS   64                     ///< Added to the quarter hours, 0 is reserved for invalid values
+#define LibCpp_PACKEDTIME_INVALID    INT64_MIN              ///< Value of an invalid cPackedTime
+
+/**
+ * @brief \ref GZC time stamp packed into a single 64 bit integer.
+ * The unix time is held in the upper 55 bits, followed by the dst state (-1 UTC, 0 STD, 1 DST) and the
+ * time zone in quarter hours (-15:45 till +15:45). Thus the values sort chronologically as plain
+ * signed integers, instants being equal are ordered by dst and zone.\n
+ * The conversion to and from stCalendar and GZC strings is lossless for all time zones being a
+ * multiple of 15 minutes (all zones of the time zone data base since 1980).
+ * \code
+ * cPackedTime stamp = cPackedTime::set("2023-09-20#17:17:38#DST#+01:00");
+ * int64_t stored = stamp.value();                                      // 8 bytes instead of 24 or 30
+ * std::string text = cPackedTime::fromValue(stored).toString();        // "2023-09-20#17:17:38#DST#+01:00"
+ * \endcode
+**/
+class cPackedTime
+{
+public:
+    constexpr cPackedTime() : _value(LibCpp_PACKEDTIME_INVALID) {}     ///< Constructor, the value is invalid.
+
+    static constexpr cPackedTime set(time_t unixTime, stTimeZone zone, int8_t dst);    ///< Packs a unix time with its zone and dst.
+    static constexpr cPackedTime set(const stCalendar& calendar);                       ///< Packs calendar data carrying a valid zone.
+    static cPackedTime           set(std::string_view gzcString);                       ///< Packs a \ref GZC string.
+    static constexpr cPackedTime fromValue(int64_t value) { cPackedTime result; result._value = value; return result; } ///< Instance of a stored value.
+
+    constexpr bool       isValid() const { return (_value & ((1 << LibCpp_PACKEDTIME_ZONEBITS) - 1)) != 0; } ///< True if a time stamp is held.
+    constexpr int64_t    value() const { return _value; }                               ///< Packed value, sorts chronologically.
+    constexpr time_t     unixTime() const;                                              ///< Unix time.
+    constexpr stTimeZone timeZone() const;                                              ///< Geographic time zone (dst = 0 or 1) or UTC relative time zone (dst = -1).
+    constexpr int8_t     dst() const;                                                   ///< 1 = DST, 0 = STD, -1 = UTC relative zone.
+    constexpr stCalendar calendar() const;                                              ///< Calendar data, stCalendar_Invalid if not valid.
+    std::string          toString() const;                                              ///< \ref GZC string, empty if not valid.
+
+    constexpr bool operator==(const cPackedTime& a) const { return _value == a._value; } ///< operator ==
+    constexpr bool operator!=(const cPackedTime& a) const { return _value != a._value; } ///< operator !=
+    constexpr bool operator< (const cPackedTime& a) const { return _value <  a._value; } ///< operator <
+    constexpr bool operator> (const cPackedTime& a) const { return _value >  a._value; } ///< operator >
+    constexpr bool operator<=(const cPackedTime& a) const { return _value <= a._value; } ///< operator <=
+    constexpr bool operator>=(const cPackedTime& a) const { return _value >= a._value; } ///< operator >=
+
+private:
+    int64_t _value;     ///< Unix time << 9 | (dst + 1) << 7 | (quarter hours + 64)
+};
+
+/**
+ * @brief Packs a unix time with its zone and dst.
+ * @param unixTime Unix time within +-2^54 seconds
+ * @param zone Zone -15:45 till +15:45 in steps of 15 minutes
+ * @param dst 1 = DST, 0 = STD, -1 = UTC relative zone
+ * @return Packed time, invalid if a value is out of range
+ */
+constexpr cPackedTime cPackedTime::set(time_t unixTime, stTimeZone zone, int8_t dst)
+{
+    cPackedTime result;
+    int32_t quarters = zone.hours * 4 + ((zone.hours < 0) ? -1 : 1) * (zone.minutes / 15);
+    if (zone.minutes % 15 != 0 || quarters <= -LibCpp_PACKEDTIME_ZONEBIAS || quarters >= LibCpp_PACKEDTIME_ZONEBIAS) return result;
+    if (dst < -1 || dst > 1) return result;
+    if ((int64_t)unixTime < -((int64_t)1 << (63 - LibCpp_PACKEDTIME_TIMESHIFT)) || (int64_t)unixTime >= ((int64_t)1 << (63 - LibCpp_PACKEDTIME_TIMESHIFT))) return result;
+    result._value = (int64_t)((uint64_t)(int64_t)unixTime << LibCpp_PACKEDTIME_TIMESHIFT)
+                  | ((int64_t)(dst + 1) << LibCpp_PACKEDTIME_ZONEBITS)
+                  | (quarters + LibCpp_PACKEDTIME_ZONEBIAS);
+    return result;
+}
+
+/**
+ * @brief Packs calendar data carrying a valid zone.
+ * Entries exceeding their range are carried over like mktime() does. An invalid dst is taken as UTC relative zone.
+ * @param calendar
+ * @return Packed time, invalid if the calendar has no valid zone
+ */
+constexpr cPackedTime cPackedTime::set(const stCalendar& calendar)
+{
+    if (calendar.timeZone.hours == INT8_INVALID || calendar.year == INT32_INVALID) return cPackedTime();
+    int8_t dst = (calendar.dst == 0 || calendar.dst == 1) ? calendar.dst : -1;
+    return set(calendarMath::calendarToUnix(calendar), calendar.timeZone, dst);
+}
+
+/**
+ * @brief Unix time.
+ * @return Unix time, undefined if not valid
+ */
+constexpr time_t cPackedTime::unixTime() const
+{
+    return (time_t)calendarMath::floorDivision(_value, (int64_t)1 << LibCpp_PACKEDTIME_TIMESHIFT);
+}
+
+/**
+ * @brief Time zone, the minutes carry the sign of the hours.
+ * @return Geographic time zone (dst = 0 or 1) or UTC relative time zone (dst = -1)
+ */
+constexpr stTimeZone cPackedTime::timeZone() const
+{
+    int32_t quarters = (int32_t)(_value & ((1 << LibCpp_PACKEDTIME_ZONEBITS) - 1)) - LibCpp_PACKEDTIME_ZONEBIAS;
+    int32_t minutes = (quarters % 4) * 15;
+    return stTimeZone{(int8_t)(quarters / 4), (uint8_t)(minutes < 0 ? -minutes : minutes)};
+}
+
+/**
+ * @brief Daylight saving time state.
+ * @return 1 = DST, 0 = STD, -1 = UTC relative zone
+ */
+constexpr int8_t cPackedTime::dst() const
+{
+    return (int8_t)(((_value >> LibCpp_PACKEDTIME_ZONEBITS) & ((1 << LibCpp_PACKEDTIME_DSTBITS) - 1)) - 1);
+}
+
+/**
+ * @brief Calendar data within the packed zone.
+ * @return calendar struct, stCalendar_Invalid if not valid
+ */
+constexpr stCalendar cPackedTime::calendar() const
+{
+    if (!isValid()) return stCalendar_Invalid;
+    return calendarMath::unixToCalendar(unixTime(), timeZone(), dst());
+}
+
+}
+#endif // cPackedTime_H
+
+/** @} */
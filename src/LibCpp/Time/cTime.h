@@ -14,6 +14,7 @@
 
 #include <time.h>
 #include <string>
+#include <string_view>
 #include <stdint.h>
 #include <iostream>
 
@@ -22,6 +23,10 @@
 namespace LibCpp
 {
 
+class cZoneInfo;
+class cZoneRule;
+class cCalendarView;
+
 extern int8_t int8Zero;             ///< int8Zero
 extern int8_t int8_0x80;            ///< int8_0x80
 //extern const char* weekdays[8];     ///< weekdays
@@ -43,7 +48,7 @@ typedef struct _stCalendar
     uint8_t    second;        ///< second 0-59
     int8_t     dst;           ///< daylight saving time 1=active 0=inaktive(standard) -1 unspecified (0 will be assumed as in this case geographycal and relative time zones are equal, see \ref cTime)
     stTimeZone timeZone;      ///< time zone -12 to +12 hours as geographical time zone (anytime the standard time time-zone, see \ref cTime). Relative UTC time zone if dst = -1.
-    uint32_t   picoSeconds;   ///< pico seconds after the specified second
+    uint32_t   nanoSeconds;   ///< nano seconds after the specified second 0-999999999
 
     uint16_t   dayInYear;     ///< 1-366 as 1 for the 1st of January
     uint8_t    dayInWeek;     ///< 1-7 as 1 for monday
@@ -74,6 +79,50 @@ typedef struct _stDuration
 
 extern const stDuration stDuration_Ini; ///< stDuration_Ini
 
+/**
+ * @brief Column (structure of arrays) output of calendar data, see cTime::calendarColumns.
+ * Initialize with LibCpp::stCalendarColumns_Ini.\n
+ * Each entry points to an array holding at least as many elements as values are converted.
+ * Entries set to zero are not written.
+**/
+typedef struct _stCalendarColumns
+{
+    int32_t*  year;         ///< year
+    uint8_t*  month;        ///< month 1-12
+    uint8_t*  day;          ///< day 1-31
+    uint8_t*  hour;         ///< hour 0-23
+    uint8_t*  minute;       ///< minute 0-59
+    uint8_t*  second;       ///< second 0-59
+    uint8_t*  dayInWeek;    ///< 1-7 as 1 for monday
+    uint16_t* dayInYear;    ///< 1-366 as 1 for the 1st of January
+} stCalendarColumns;
+
+extern const stCalendarColumns stCalendarColumns_Ini; ///< stCalendarColumns_Ini
+
+/**
+ * @brief Clock sources of cTime::now(enClock), see cTimeClock.cpp.
+ * The error bound of each source is given by cTime::clockError().
+**/
+enum enClock
+{
+    enClock_realtime = 0,   ///< clock_gettime(CLOCK_REALTIME), exact (same as cTime::now())
+    enClock_coarse   = 1,   ///< CLOCK_REALTIME_COARSE, time of the last timer interrupt (late by up to one tick, typically 1-4 ms)
+    enClock_tsc      = 2,   ///< Time stamp counter calibrated against CLOCK_REALTIME (error of a few micro seconds, CLOCK_REALTIME if no invariant TSC)
+    enClock_ticker   = 3    ///< Time published by a background thread (late by up to LibCpp_TICKERINTERVAL plus the scheduling delay)
+};
+
+#define LibCpp_GZCLENGTH 30         ///< Length of a GZC string, e.g. "2023-09-20#17:17:38#DST#+01:00"
+#define LibCpp_TIMESTRINGSIZE 32    ///< Size of the buffer of cTime::nowString() including termination
+
+/**
+ * @brief Layouts of the cached current time strings of cTime::nowString().
+**/
+enum enTimeString
+{
+    enTimeString_GZC     = 0,   ///< \ref GZC default format, e.g. "2023-09-20#17:17:38#DST#+01:00"
+    enTimeString_RFC3339 = 1    ///< RFC 3339 of the local time with its full UTC offset, e.g. "2023-09-20T17:17:38+02:00" (Europe/Berlin in summer, "+00:00" for a UTC zone)
+};
+
 /**
  * @brief C++ class for time representation and calculations
 **/
@@ -87,50 +136,91 @@ public:
     cTime();                                    ///< Constructor.
 
     static cTime now();                         ///< Deliveres a cTime instance holding the current time.
+    static cTime now(enClock clock);            ///< Deliveres a cTime instance holding the current time read from the given clock source.
+    static int64_t clockError(enClock clock);   ///< Upper bound of the error of a clock source in nano seconds.
+    static size_t  nowString(char* destination, enTimeString kind = enTimeString_GZC);   ///< Copies the current time as string rendered once per second (see cTimeClock.cpp), destination holds LibCpp_TIMESTRINGSIZE characters.
+    static std::string nowString(enTimeString kind = enTimeString_GZC);                 ///< Current time as string rendered once per second (see cTimeClock.cpp).
     static cTime set(time_t unixTime);          ///< Deliveres a cTime instance initialized with unixTime.
+    static cTime set(time_t unixTime, int64_t nanoSeconds); ///< Deliveres a cTime instance initialized with unixTime and nano seconds after it (carried into the seconds if not within 0-999999999).
     static cTime set(stCalendar calendar);      ///< Deliveres a cTime instance initialized with the calendar data input.
+    static cTime set(stCalendar calendar, const cZoneRule& rule); ///< Deliveres a cTime instance initialized with the calendar data input, taken as wall clock time of a POSIX TZ rule if no zone is given (see cZoneRule.h).
     static cTime set(stDuration timeDuration);  ///< Deliveres a cTime instance initialized with the given time duration information.
     static cTime set(int32_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second); ///< Deliveres a cTime instance representing the given calendar data according to the local clock configuration.
     static cTime set(int32_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second, uint8_t dst, int8_t zoneHours, uint8_t zoneMinutes = 0); ///< Deliveres a cTime instance representing the given calendar data. @anchor DST dst=1 daylight saving time, dst=0 standard time, dst=-1 UTC relative time deviation
     static cTime set(uint64_t days, uint64_t hours, uint64_t minutes, uint64_t seconds, int8_t sign = 1); ///< Deliveres a cTime instance representing the given duration data.
-    static cTime set(std::string dateString, std::string format = ""); ///< Deliveres a cTime instance from a given character string time representation. A format string may be added (see LibOb_strptime)
+    static cTime set(std::string_view dateString, const std::string& format = ""); ///< Deliveres a cTime instance from a given character string time representation. A format string may be added (see LibOb_strptime)
 
-    time_t     time();                          ///< Returns the unix time stamp (seconds till 1.1.1970 00:00:00 GMT).
+    time_t     time() const;                    ///< Returns the unix time stamp (seconds till 1.1.1970 00:00:00 GMT).
+    uint32_t   nanoSeconds() const;             ///< Returns the nano seconds after the unix time stamp (0-999999999).
     stCalendar calendar(int8_t* pRequestedTimeZone = nullptr);  ///< Returns the calendar data representation of the instance. A UTC time deviation can be chosen.
+    stCalendar calendar(const cZoneInfo& zone);                 ///< Returns the calendar data representation of the instance within a geographic zone of the time zone data base (see cZoneInfo.h).
+    stCalendar calendar(const cZoneRule& rule);                 ///< Returns the calendar data representation of the instance within a zone defined by a POSIX TZ string (see cZoneRule.h).
     stDuration duration();                      ///< Returns the internal unix time value as duration information.
+    cCalendarView view(int8_t* pRequestedTimeZone = nullptr);   ///< Returns a calendar view calculating each entry when asked for (see cCalendarView.h). A UTC time deviation can be chosen.
+    int32_t    year(int8_t* pRequestedTimeZone = nullptr);      ///< Returns the year of the calendar data representation without calculating the other entries.
+    uint8_t    month(int8_t* pRequestedTimeZone = nullptr);     ///< Returns the month 1-12 of the calendar data representation without calculating the other entries.
+    uint8_t    day(int8_t* pRequestedTimeZone = nullptr);       ///< Returns the day 1-31 of the calendar data representation without calculating the other entries.
+    uint8_t    hour(int8_t* pRequestedTimeZone = nullptr);      ///< Returns the hour 0-23 of the calendar data representation without calculating the date.
+    uint8_t    minute(int8_t* pRequestedTimeZone = nullptr);    ///< Returns the minute 0-59 of the calendar data representation without calculating the date.
+    uint8_t    second(int8_t* pRequestedTimeZone = nullptr);    ///< Returns the second 0-59 of the calendar data representation without calculating the date.
+    uint8_t    dayInWeek(int8_t* pRequestedTimeZone = nullptr); ///< Returns the day in the week 1-7 (1 = monday) of the calendar data representation without calculating the date.
+    uint16_t   dayInYear(int8_t* pRequestedTimeZone = nullptr); ///< Returns the day in the year 1-366 of the calendar data representation without calculating the other entries.
 
     std::string toString(std::string format = "", enLanguage* pLanguage = &LibOb_GLOBALLANGUAGE, int8_t* pRequestedTimeZone = nullptr);  ///< Returns a string interpretation of the 'calendar' method result
     std::string toDurationString();             ///< Returns a string representing a duration format
-
-    inline bool operator==(const cTime& a) { return _time == a._time; }             ///< operator ==
-    inline bool operator!=(const cTime& a) { return _time != a._time; }             ///< operator !=
-    inline bool operator< (const cTime& a) { return _time < a._time; }              ///< operator <
-    inline bool operator> (const cTime& a) { return _time > a._time; }              ///< operator >
-    inline bool operator<=(const cTime& a) { return _time <= a._time; }             ///< operator <=
-    inline bool operator>=(const cTime& a) { return _time >= a._time; }             ///< operator >=
-    inline cTime operator+(const cTime& a) { return cTime::set(_time + a._time); }  ///< operator +
-    inline cTime operator-(const cTime& a) { return cTime::set(_time - a._time); }  ///< operator -
-    inline cTime operator+=(const cTime& a) { return cTime::set(_time + a._time); } ///< operator +=
-    inline cTime operator-=(const cTime& a) { return cTime::set(_time - a._time); } ///< operator -=
+    size_t      format(char* destination, size_t destinationSize, const char* format = "", enLanguage* pLanguage = &LibOb_GLOBALLANGUAGE, int8_t* pRequestedTimeZone = nullptr); ///< Writes the string interpretation of the 'calendar' method result to a buffer, no heap allocation
+    template <typename F, typename = decltype(F::isTimeFormat())> std::string toString(F format, enLanguage* pLanguage = &LibOb_GLOBALLANGUAGE, int8_t* pRequestedTimeZone = nullptr); ///< Returns a string interpretation of the 'calendar' method result using a compile time format (see cTimeFormat.h)
+
+    inline bool operator==(const cTime& a) { return _time == a._time && _nanoSeconds == a._nanoSeconds; }   ///< operator ==
+    inline bool operator!=(const cTime& a) { return _time != a._time || _nanoSeconds != a._nanoSeconds; }   ///< operator !=
+    inline bool operator< (const cTime& a) { return _time < a._time || (_time == a._time && _nanoSeconds < a._nanoSeconds); }   ///< operator <
+    inline bool operator> (const cTime& a) { return _time > a._time || (_time == a._time && _nanoSeconds > a._nanoSeconds); }   ///< operator >
+    inline bool operator<=(const cTime& a) { return !(*this > a); }                 ///< operator <=
+    inline bool operator>=(const cTime& a) { return !(*this < a); }                 ///< operator >=
+    inline cTime operator+(const cTime& a) { return cTime::set(_time + a._time, (int64_t)_nanoSeconds + a._nanoSeconds); }  ///< operator +
+    inline cTime operator-(const cTime& a) { return cTime::set(_time - a._time, (int64_t)_nanoSeconds - a._nanoSeconds); }  ///< operator -
+    inline cTime operator+=(const cTime& a) { return cTime::set(_time + a._time, (int64_t)_nanoSeconds + a._nanoSeconds); } ///< operator +=
+    inline cTime operator-=(const cTime& a) { return cTime::set(_time - a._time, (int64_t)_nanoSeconds - a._nanoSeconds); } ///< operator -=
     friend std::ostream & operator << (std::ostream &out, const cTime &t);          ///< stream operator >>
     friend std::istream & operator >> (std::istream &in, cTime &t);                 ///< stream operator >>
 
     static stTimeZone localTimeZone(int8_t* pDst = nullptr);                ///< Retrieves the local geographic time zone and dst information.
+    static void       invalidateZoneContext();                              ///< Discards the cached local time zone, e.g. after changing the TZ environment variable.
+    static bool       checkZoneContext();                                   ///< Invalidates the cached local time zone if TZ or /etc/localtime changed. Returns true if so.
+    static uint64_t   zoneContextRecomputations();                          ///< Number of times the cached local time zone has been computed.
     static stTimeZone UTCdeviation(stTimeZone zone, int8_t dst);            ///< Calculates the relative deviation from UTC (GMT) time.
 
     static stCalendar  setCalendar(int32_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second); ///< Deliveres a stCalendar struct representing the given calendar data using the local geographic time zone
     static stCalendar  setCalendar(int32_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second, uint8_t dst, int8_t zoneHours, uint8_t zoneMinutes = 0); ///< Deliveres a calendar struct representing the given numeric calendar data. (see @ref DST dst)
     static stDuration  setDuration(uint64_t day, uint64_t hour, uint64_t minute, uint64_t second, int8_t sign = 1);         ///< Deliveres a stCalendar struct representing the given calendar data using the local geographic time zone
-    static stCalendar  fromString(std::string dateString, std::string format);  ///< Delivers a calendar struct from a \ref GZC formatted string
+    static stCalendar  fromString(std::string_view dateString, const std::string& format);  ///< Delivers a calendar struct from a \ref GZC formatted string
+    static const char* scanGZC(const char* source, time_t* pUnixTime);          ///< Converts a \ref GZC string of the fixed layout "2023-09-20#17:17:38#DST#+01:00" to unix time.
+    static const char* scan(const char* source, size_t sourceLength, const char* format, time_t* pUnixTime, uint32_t* pNanoSeconds = nullptr); ///< Converts a numeric calendar string to unix time in a single pass, mktime is only called for local wall clock times the zone cache cannot resolve.
     static stDuration  fromDurationString(std::string durationString);          ///< Delivers a duration struct from a \ref GZC formatted string
     static std::string toString(stCalendar calendar, std::string format = "", enLanguage* pLanguage = &LibOb_GLOBALLANGUAGE);       ///< Generates a \ref GZC formatted string from a calendar struct
     static std::string toString(stDuration duration);                           ///< Generates a \ref GZC formatted string from a duration struct
+    static size_t      format(char* destination, size_t destinationSize, const stCalendar& calendar, const char* format = "", enLanguage* pLanguage = &LibOb_GLOBALLANGUAGE); ///< Writes a \ref GZC formatted string of a calendar struct to a buffer, the numbers are written directly from the calendar entries
+    template <typename F, typename = decltype(F::isTimeFormat())> static std::string toString(stCalendar calendar, F format, enLanguage* pLanguage = &LibOb_GLOBALLANGUAGE); ///< Generates a \ref GZC formatted string using a compile time format (see cTimeFormat.h)
 
     static struct tm   fromCalendar(stCalendar calendar, stTimeZone* pTimeZone = nullptr);      ///< Converts a struct calendar to struct tm and time zone
     static stCalendar  toCalendar(struct tm tmCalendar, const stTimeZone* pTimeZone = nullptr); ///< Converts struct tm and time zone to a struct calendar
 
+    static int32_t     zoneOffset(stTimeZone zone, int8_t dst);                                 ///< Seconds to add to UTC to receive the wall clock time of the given zone and dst.
+    static int64_t     daysFromCivil(int32_t year, uint8_t month, uint8_t day);                 ///< Days since 1.1.1970 of a (proleptic gregorian) date. Pure arithmetic.
+    static void        civilFromDays(int64_t days, int32_t* pYear, uint8_t* pMonth, uint8_t* pDay, uint16_t* pDayInYear = nullptr); ///< Date of the given days since 1.1.1970. Pure arithmetic.
+    static stCalendar  unixToCalendar(time_t unixTime, stTimeZone zone = stTimeZone_Ini, int8_t dst = -1); ///< Calendar data of a unix time within a fixed zone. Pure arithmetic, the date of the last converted day is memorized per thread.
+    static stCalendar  unixToCalendar(time_t unixTime, int32_t utcOffset, stTimeZone zone, int8_t dst); ///< Calendar data of a unix time at the given UTC offset, labelled with zone and dst. Pure arithmetic, shares the per thread day memory.
+    static uint64_t    dayCacheHits();                                                          ///< Number of conversions of the calling thread taking the date from the last converted day.
+    static uint64_t    dayCacheMisses();                                                        ///< Number of conversions of the calling thread calculating the date.
+    static time_t      calendarToUnix(stCalendar calendar);                                     ///< Unix time of calendar data carrying a valid zone. Pure arithmetic.
+    static void        calendarColumns(const time_t* pUnixTimes, size_t count, stCalendarColumns columns, stTimeZone zone = stTimeZone_Ini, int8_t dst = -1); ///< Converts an array of unix times to calendar data columns within a fixed zone.
+
 private:
-    time_t _time;           ///< System (original) Unix / UTC time in seconds since 1.1.1970 00:00:00 Greenwich mean time
+    void requestedZone(int8_t* pRequestedTimeZone, stTimeZone* pZone, int8_t* pDst, int32_t* pUtcOffset);  ///< Zone, dst and UTC offset of the calendar data representation, see calendar().
+    static time_t localToUnix(int64_t wallClock, int8_t dst);                         ///< Unix time of a wall clock time of the local zone, see calendar().
+
+    time_t   _time;         ///< System (original) Unix / UTC time in seconds since 1.1.1970 00:00:00 Greenwich mean time
+    uint32_t _nanoSeconds;  ///< Nano seconds after _time 0-999999999
 };
 
 }
@@ -0,0 +1,589 @@
+// utf-8 (ü)
+
+// MIT License
+// Copyright © 2023 Olaf Simon
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+/**
+ * @file   cTimeClock.cpp
+ * @author Olaf Simon
+ * @brief  Clock sources of cTime::now(enClock)
+ *
+ * \addtogroup LibCpp_time
+ * @{
+ *
+ * cTime::now() reads CLOCK_REALTIME with nano second resolution. Callers taking a time stamp at a
+ * high rate (e.g. per log line or per received message) often do not need that precision and can
+ * choose a cheaper clock source per call site:
+ *
+ * - enClock_coarse: CLOCK_REALTIME_COARSE is the time of the last timer interrupt. It is read from
+ *   the vDSO without reading a hardware clock. The time is late by up to one timer tick (1-4 ms
+ *   depending on the kernel configuration, see clock_getres()). A tickless kernel may skip ticks
+ *   of an idle processor, thus the first read after an idle phase can be late by some ticks.
+ * - enClock_tsc: The time stamp counter of the processor is read and scaled by a factor calibrated
+ *   against CLOCK_REALTIME. The calibration is renewed each LibCpp_TSCANCHORPERIOD, thus the error
+ *   stays in the range of the uncertainty of reading both clocks (about 20 micro seconds during the
+ *   first second after the 10 ms start up calibration, less than a micro second afterwards). Steps of
+ *   CLOCK_REALTIME are followed within one period. The time may step back by the error when the
+ *   calibration is renewed.
+ *   Without an invariant time stamp counter CLOCK_REALTIME is used.
+ * - enClock_ticker: A background thread reads CLOCK_REALTIME each LibCpp_TICKERINTERVAL and
+ *   publishes it through a sequence lock. Reading is two loads of shared memory. The time is late by
+ *   up to the interval plus the delay of scheduling the thread. The thread is started with the first
+ *   use and stopped at exit.
+ *
+ * The ticker thread also renders the \ref GZC and the RFC 3339 string of the current second once per
+ * second, similar to the cached time strings of nginx. Both hold the local wall clock time, the RFC 3339
+ * string with the full UTC offset valid at that second (dst included, "+00:00" if the local zone is UTC). cTime::nowString() copies them out of a double
+ * buffer guarded by a sequence, thus logging the current time takes neither a lock nor formatting.
+ *
+ * \code
+ * cTime stamp = cTime::now(enClock_ticker);        // per log line
+ * int64_t error = cTime::clockError(enClock_ticker); // 1000000 ns
+ * \endcode
+**/
+
+#include "cTime.h"
+#include "cCalendarMath.h"
+#include "cTimeFormat.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define LibCpp_CLOCK_TSC                ///< Time stamp counter available
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+        #include <cpuid.h>
+    #endif
+#endif
+
+using namespace LibCpp;
+
+#define LibCpp_TSCCALIBRATION  10000000     ///< Nano seconds of the first calibration of the time stamp counter
+#define LibCpp_TSCANCHORPERIOD 1000000000   ///< Nano seconds after which the time stamp counter is calibrated again
+#define LibCpp_TSCPAIRERROR    100          ///< Nano seconds of uncertainty of reading CLOCK_REALTIME and the time stamp counter together
+#define LibCpp_TSCMAXDEVIATION 1000         ///< Maximum rate change in ppm accepted by a renewed calibration (otherwise CLOCK_REALTIME was set)
+#define LibCpp_TICKERINTERVAL  1000000      ///< Nano seconds between two updates of the ticker clock
+
+/**
+ * @brief Values written by one thread and read lock free by any thread (sequence lock).
+ * The writer makes the sequence odd while writing. A reader repeats if the sequence was odd or
+ * has changed while reading.
+ */
+typedef struct _stSeqLock
+{
+    std::atomic<uint32_t> sequence;     ///< Incremented before and after writing
+    std::atomic<int64_t>  values[4];    ///< Published values
+} stSeqLock;
+
+/**
+ * @brief Publishes values of a sequence lock. Only one thread may write at a time.
+ * @param lock
+ * @param pValues 4 values
+ */
+static void seqLockWrite(stSeqLock& lock, const int64_t* pValues)
+{
+    uint32_t sequence = lock.sequence.load(std::memory_order_relaxed);
+    lock.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int n=0; n<4; n++)
+        lock.values[n].store(pValues[n], std::memory_order_relaxed);
+    lock.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+/**
+ * @brief Reads consistent values of a sequence lock.
+ * @param lock
+ * @param pValues Destination of 4 values
+ */
+static void seqLockRead(const stSeqLock& lock, int64_t* pValues)
+{
+    uint32_t sequence;
+    do
+    {
+        sequence = lock.sequence.load(std::memory_order_acquire);
+        for (int n=0; n<4; n++)
+            pValues[n] = lock.values[n].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((sequence & 1) || sequence != lock.sequence.load(std::memory_order_relaxed));
+}
+
+/**
+ * @brief Reads CLOCK_REALTIME.
+ * @return Nano seconds since 1.1.1970 00:00:00 UTC
+ */
+static int64_t realtimeNanoSeconds()
+{
+    struct timespec now;
+#ifdef _WIN32
+    timespec_get(&now, TIME_UTC);
+#else
+    clock_gettime(CLOCK_REALTIME, &now);
+#endif
+    return (int64_t)now.tv_sec * LibCpp_NANOSECONDSPERSECOND + now.tv_nsec;
+}
+
+/**
+ * @brief Reads the monotonic clock, which is not affected by setting CLOCK_REALTIME.
+ * @return Nano seconds since an unspecified start
+ */
+static int64_t steadyNanoSeconds()
+{
+    return (int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Resolution of a clock.
+ * @param clock POSIX clock id
+ * @return Nano seconds
+ */
+#ifndef _WIN32
+static int64_t clockResolution(clockid_t clock)
+{
+    struct timespec resolution;
+    if (clock_getres(clock, &resolution) != 0) return 0;
+    return (int64_t)resolution.tv_sec * LibCpp_NANOSECONDSPERSECOND + resolution.tv_nsec;
+}
+#endif
+
+#ifdef LibCpp_CLOCK_TSC
+
+/**
+ * @brief Time stamp counter calibrated against CLOCK_REALTIME.
+ * The first rate is measured against the monotonic clock, thus setting CLOCK_REALTIME meanwhile does not
+ * disturb it. The anchor holds the counter and CLOCK_REALTIME of the last calibration, the nano seconds per
+ * tick as 32.32 fixed point value and the ticks of one LibCpp_TSCANCHORPERIOD. The product of
+ * ticks and factor cannot overflow within two periods.
+ */
+class cTscClock
+{
+public:
+    cTscClock();                    ///< Checks for an invariant counter and calibrates it.
+    bool    usable() const { return _usable; }                                      ///< True if the counter is invariant and its rate could be measured.
+    int64_t error() const { return _error.load(std::memory_order_relaxed); }        ///< Error bound of the last calibration in nano seconds.
+    int64_t now();                  ///< Nano seconds since 1.1.1970 00:00:00 UTC.
+
+private:
+    static int64_t readPair(uint64_t* pTicks, int64_t (*pClock)() = realtimeNanoSeconds); ///< Reads a clock (CLOCK_REALTIME) and the counter as close together as possible.
+    int64_t calibrate(const int64_t* pAnchor);      ///< Calibrates again, returns CLOCK_REALTIME.
+
+    bool                 _usable;   ///< Invariant time stamp counter with measured rate
+    stSeqLock            _anchor;   ///< Counter, CLOCK_REALTIME, factor, ticks per period
+    std::atomic_flag     _busy;     ///< Set while a thread calibrates
+    std::atomic<int64_t> _error;    ///< Error bound in nano seconds
+};
+
+/**
+ * @brief Checks for an invariant counter and calibrates it over LibCpp_TSCCALIBRATION.
+ * The rate is measured against the monotonic clock. If no positive rate is measured within
+ * three tries, the counter is marked as not usable and CLOCK_REALTIME is read instead.
+ */
+cTscClock::cTscClock()
+{
+    _anchor.sequence.store(0, std::memory_order_relaxed);
+    _busy.clear();
+    _error.store(0, std::memory_order_relaxed);
+
+    unsigned int registers[4] = {0, 0, 0, 0};
+#ifdef _MSC_VER
+    __cpuid((int*)registers, 0x80000000);
+    if (registers[0] >= 0x80000007) __cpuid((int*)registers, 0x80000007);
+#else
+    if (__get_cpuid_max(0x80000000, nullptr) >= 0x80000007)
+        __get_cpuid(0x80000007, &registers[0], &registers[1], &registers[2], &registers[3]);
+#endif
+    _usable = (registers[3] & (1 << 8)) != 0;      // EDX bit 8: constant rate in all power states
+    if (!_usable) return;
+
+    int64_t factor = 0;
+    int64_t elapsed = 0;
+    for (int n=0; n<3 && factor <= 0; n++)
+    {
+        uint64_t startTicks = 0;
+        uint64_t endTicks = 0;
+        int64_t start = readPair(&startTicks, steadyNanoSeconds);
+        while (steadyNanoSeconds() - start < LibCpp_TSCCALIBRATION);
+        elapsed = readPair(&endTicks, steadyNanoSeconds) - start;
+        if (elapsed > 0 && endTicks > startTicks)
+            factor = (int64_t)(((uint64_t)elapsed << 32) / (endTicks - startTicks));
+    }
+    if (factor <= 0)
+    {
+        _usable = false;
+        return;
+    }
+    _error.store(LibCpp_TSCPAIRERROR + 2 * LibCpp_TSCPAIRERROR * (int64_t)LibCpp_TSCANCHORPERIOD / elapsed, std::memory_order_relaxed);
+
+    uint64_t ticks = 0;
+    int64_t now = readPair(&ticks);
+    int64_t anchor[4] = {(int64_t)ticks, now, factor, (int64_t)(((uint64_t)LibCpp_TSCANCHORPERIOD << 32) / (uint64_t)factor)};
+    seqLockWrite(_anchor, anchor);
+}
+
+/**
+ * @brief Reads a clock and the counter as close together as possible.
+ * The counter is read before and after the clock, the shortest of some tries is taken.
+ * @param pTicks Counter in the middle of the read clock
+ * @param pClock Clock to be read, CLOCK_REALTIME by default
+ * @return Clock in nano seconds
+ */
+int64_t cTscClock::readPair(uint64_t* pTicks, int64_t (*pClock)())
+{
+    uint64_t window = UINT64_MAX;
+    int64_t result = 0;
+    for (int n=0; n<5; n++)
+    {
+        uint64_t before = __rdtsc();
+        int64_t now = pClock();
+        uint64_t after = __rdtsc();
+        if (after - before < window)
+        {
+            window = after - before;
+            result = now;
+            *pTicks = before + window / 2;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Calibrates the factor over the time since the anchor and publishes the new anchor.
+ * A rate deviating more than LibCpp_TSCMAXDEVIATION from the previous factor is not taken,
+ * as CLOCK_REALTIME was set in between. The factor of the previous anchor is never zero (see cTscClock()).
+ * @param pAnchor Previous anchor
+ * @return CLOCK_REALTIME of the new anchor
+ */
+int64_t cTscClock::calibrate(const int64_t* pAnchor)
+{
+    uint64_t ticks = 0;
+    int64_t now = readPair(&ticks);
+    uint64_t elapsedTicks = ticks - (uint64_t)pAnchor[0];
+    int64_t elapsed = now - pAnchor[1];
+
+    int64_t factor = pAnchor[2];
+    if (elapsed > 0 && elapsedTicks > 0)
+    {
+        int64_t measured = (int64_t)(((uint64_t)elapsed << 32) / elapsedTicks);
+        if (factor == 0 || (measured > factor - factor / 1000000 * LibCpp_TSCMAXDEVIATION && measured < factor + factor / 1000000 * LibCpp_TSCMAXDEVIATION))
+        {
+            factor = measured;
+            // both pairs are uncertain, the rate error accumulates over one period
+            _error.store(LibCpp_TSCPAIRERROR + 2 * LibCpp_TSCPAIRERROR * (int64_t)LibCpp_TSCANCHORPERIOD / elapsed, std::memory_order_relaxed);
+        }
+    }
+    int64_t anchor[4] = {(int64_t)ticks, now, factor, (int64_t)(((uint64_t)LibCpp_TSCANCHORPERIOD << 32) / (uint64_t)factor)};
+    seqLockWrite(_anchor, anchor);
+    return now;
+}
+
+/**
+ * @brief Reads the counter and converts it with the anchor.
+ * After LibCpp_TSCANCHORPERIOD one thread calibrates again, the other threads continue
+ * with the previous anchor up to a second period.
+ * @return Nano seconds since 1.1.1970 00:00:00 UTC
+ */
+int64_t cTscClock::now()
+{
+    int64_t anchor[4];
+    seqLockRead(_anchor, anchor);
+    uint64_t ticks = __rdtsc() - (uint64_t)anchor[0];
+    if (ticks < (uint64_t)anchor[3])
+        return anchor[1] + (int64_t)((ticks * (uint64_t)anchor[2]) >> 32);
+
+    if (!_busy.test_and_set(std::memory_order_acquire))
+    {
+        int64_t result = calibrate(anchor);
+        _busy.clear(std::memory_order_release);
+        return result;
+    }
+    if (ticks < 2 * (uint64_t)anchor[3])
+        return anchor[1] + (int64_t)((ticks * (uint64_t)anchor[2]) >> 32);
+    return realtimeNanoSeconds();
+}
+
+/**
+ * @brief The time stamp counter clock, calibrated with the first use.
+ * @return Instance
+ */
+static cTscClock& tscClock()
+{
+    static cTscClock clock;
+    return clock;
+}
+
+#endif // LibCpp_CLOCK_TSC
+
+/**
+ * @brief Time strings of one second, one slot of the double buffer of cTickerClock.
+ * The characters are held in 64 bit words, thus they are copied with a few atomic loads.
+ */
+typedef struct _stTimeStrings
+{
+    std::atomic<uint64_t> words[2][LibCpp_TIMESTRINGSIZE / 8];  ///< Characters of the strings (index = enTimeString)
+    std::atomic<uint32_t> lengths[2];                           ///< Lengths of the strings (index = enTimeString)
+} stTimeStrings;
+
+/**
+ * @brief Background thread publishing CLOCK_REALTIME each LibCpp_TICKERINTERVAL.
+ * The \ref GZC and RFC 3339 strings of the current second are rendered once per second into the
+ * slot not being read and published by incrementing the string sequence (double buffer).
+ */
+class cTickerClock
+{
+public:
+    cTickerClock();                 ///< Publishes the current time and starts the thread.
+    ~cTickerClock();                ///< Stops the thread.
+    int64_t now() const;            ///< Last published time in nano seconds since 1.1.1970 00:00:00 UTC.
+    size_t  timeString(char* destination, enTimeString kind) const; ///< Copies the last rendered time string.
+
+private:
+    void run();                     ///< Thread function.
+    void publish();                 ///< Publishes CLOCK_REALTIME and renders the strings of a new second.
+
+    stSeqLock             _time;            ///< Published time
+    stTimeStrings         _strings[2];      ///< Double buffer of the time strings
+    std::atomic<uint32_t> _stringSequence;  ///< Number of renderings, the current slot is _strings[_stringSequence & 1]
+    time_t                _renderedSecond;  ///< Second of the current slot (ticker thread only)
+    std::atomic<bool>     _stop;            ///< Set to end the thread
+    std::thread           _thread;          ///< Publishing thread
+};
+
+/**
+ * @brief Publishes the current time and starts the thread.
+ */
+cTickerClock::cTickerClock()
+{
+    _time.sequence.store(0, std::memory_order_relaxed);
+    _stringSequence.store(0, std::memory_order_relaxed);
+    _renderedSecond = INT64_MIN;
+    _stop.store(false, std::memory_order_relaxed);
+    publish();
+    _thread = std::thread(&cTickerClock::run, this);
+}
+
+/**
+ * @brief Stops the thread.
+ */
+cTickerClock::~cTickerClock()
+{
+    _stop.store(true, std::memory_order_relaxed);
+    if (_thread.joinable()) _thread.join();
+}
+
+/**
+ * @brief Thread function, publishes CLOCK_REALTIME until stopped.
+ */
+void cTickerClock::run()
+{
+    while (!_stop.load(std::memory_order_relaxed))
+    {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(LibCpp_TICKERINTERVAL));
+        publish();
+    }
+}
+
+/**
+ * @brief Publishes CLOCK_REALTIME. In a new second the strings are rendered into the other slot
+ * and published afterwards, the slot being read is not touched.
+ */
+void cTickerClock::publish()
+{
+    int64_t values[4] = {realtimeNanoSeconds(), 0, 0, 0};
+    seqLockWrite(_time, values);
+
+    time_t second = (time_t)calendarMath::floorDivision(values[0], LibCpp_NANOSECONDSPERSECOND);
+    if (second == _renderedSecond) return;
+    _renderedSecond = second;
+
+    char texts[2][LibCpp_TIMESTRINGSIZE] = {};
+    cTime time = cTime::set(second);
+    size_t lengths[2];
+    stCalendar local = time.calendar();
+    stCalendar offset = local;  // same local wall clock, labelled with its full UTC offset
+    offset.timeZone = calendarMath::offsetZone(calendarMath::zoneOffset(local.timeZone, local.dst));
+    offset.dst = -1;
+    lengths[enTimeString_GZC] = timeFormat::format(texts[enTimeString_GZC], local, LibCpp_TIMEFORMAT(""));
+    lengths[enTimeString_RFC3339] = timeFormat::format(texts[enTimeString_RFC3339], offset, LibCpp_TIMEFORMAT("%Y-%m-%dT%H:%M:%S%z"));
+
+    uint32_t sequence = _stringSequence.load(std::memory_order_relaxed);
+    stTimeStrings& slot = _strings[(sequence + 1) & 1];
+    std::atomic_thread_fence(std::memory_order_release);    // readers of the previous rendering of this slot notice the overwriting
+    for (int kind=0; kind<2; kind++)
+    {
+        for (int n=0; n<LibCpp_TIMESTRINGSIZE / 8; n++)
+        {
+            uint64_t word;
+            memcpy(&word, texts[kind] + 8*n, 8);
+            slot.words[kind][n].store(word, std::memory_order_relaxed);
+        }
+        slot.lengths[kind].store((uint32_t)lengths[kind], std::memory_order_relaxed);
+    }
+    _stringSequence.store(sequence + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Last published time.
+ * @return Nano seconds since 1.1.1970 00:00:00 UTC
+ */
+int64_t cTickerClock::now() const
+{
+    int64_t values[4];
+    seqLockRead(_time, values);
+    return values[0];
+}
+
+/**
+ * @brief Copies the last rendered time string.
+ * No lock is taken and nothing is formatted. The copy is repeated only if a rendering was
+ * published meanwhile.
+ * @param destination Buffer of LibCpp_TIMESTRINGSIZE characters
+ * @param kind
+ * @return Length without termination
+ */
+size_t cTickerClock::timeString(char* destination, enTimeString kind) const
+{
+    uint64_t words[LibCpp_TIMESTRINGSIZE / 8];
+    uint32_t length;
+    uint32_t sequence;
+    do
+    {
+        sequence = _stringSequence.load(std::memory_order_acquire);
+        const stTimeStrings& slot = _strings[sequence & 1];
+        for (int n=0; n<LibCpp_TIMESTRINGSIZE / 8; n++)
+            words[n] = slot.words[kind][n].load(std::memory_order_relaxed);
+        length = slot.lengths[kind].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while (sequence != _stringSequence.load(std::memory_order_relaxed));
+    memcpy(destination, words, LibCpp_TIMESTRINGSIZE);
+    return length;
+}
+
+/**
+ * @brief The ticker clock, started with the first use and stopped at exit.
+ * @return Instance
+ */
+static cTickerClock& tickerClock()
+{
+    static cTickerClock clock;
+    return clock;
+}
+
+/**
+ * @brief Deliveres a cTime instance holding the current time read from the given clock source.
+ * @param clock Clock source, see \ref enClock
+ * @return Created instance
+ */
+cTime cTime::now(enClock clock)
+{
+    switch (clock)
+    {
+    case enClock_coarse:
+    {
+#ifdef CLOCK_REALTIME_COARSE
+        cTime result;
+        struct timespec value;
+        clock_gettime(CLOCK_REALTIME_COARSE, &value);
+        result._time = value.tv_sec;
+        result._nanoSeconds = (uint32_t)value.tv_nsec;
+        return result;
+#else
+        return now();
+#endif
+    }
+    case enClock_tsc:
+#ifdef LibCpp_CLOCK_TSC
+        if (tscClock().usable())
+            return set((time_t)0, tscClock().now());
+#endif
+        return now();
+    case enClock_ticker:
+        return set((time_t)0, tickerClock().now());
+    default:
+        return now();
+    }
+}
+
+/**
+ * @brief Copies the current time as string, rendered once per second by the ticker clock.
+ * Neither a lock is taken nor is anything formatted. The string changes within LibCpp_TICKERINTERVAL
+ * (plus the scheduling delay of the ticker thread) after the second changed. Both layouts show the local
+ * wall clock time, the RFC 3339 string ends with the UTC offset valid at that second (Europe/Berlin in summer below).
+ * \code
+ * char stamp[LibCpp_TIMESTRINGSIZE];
+ * size_t length = cTime::nowString(stamp, enTimeString_RFC3339);  // "2023-09-20T17:17:38+02:00"
+ * \endcode
+ * @param destination Buffer of LibCpp_TIMESTRINGSIZE characters, receives the zero terminated string
+ * @param kind Layout of the string, see \ref enTimeString
+ * @return Length without termination
+ */
+size_t cTime::nowString(char* destination, enTimeString kind)
+{
+    return tickerClock().timeString(destination, kind);
+}
+
+/**
+ * @brief Current time as string, rendered once per second by the ticker clock.
+ * @param kind Layout of the string, see \ref enTimeString
+ * @return Time string
+ */
+std::string cTime::nowString(enTimeString kind)
+{
+    char buffer[LibCpp_TIMESTRINGSIZE];
+    size_t length = nowString(buffer, kind);
+    return std::string(buffer, length);
+}
+
+/**
+ * @brief Upper bound of the error of a clock source.
+ * The time stamp counter is calibrated with the first call, the ticker is started.
+ * The ticker bound does not include the delay of scheduling its thread.
+ * @param clock Clock source, see \ref enClock
+ * @return Nano seconds
+ */
+int64_t cTime::clockError(enClock clock)
+{
+    switch (clock)
+    {
+    case enClock_coarse:
+#if defined(CLOCK_REALTIME_COARSE)
+        return clockResolution(CLOCK_REALTIME_COARSE);
+#else
+        return clockError(enClock_realtime);
+#endif
+    case enClock_tsc:
+#ifdef LibCpp_CLOCK_TSC
+        if (tscClock().usable())
+            return tscClock().error();
+#endif
+        return clockError(enClock_realtime);
+    case enClock_ticker:
+        tickerClock();
+        return LibCpp_TICKERINTERVAL;
+    default:
+#ifdef _WIN32
+        return 100;     // system time in units of 100 ns
+#else
+        return clockResolution(CLOCK_REALTIME);
+#endif
+    }
+}
+
+/** @} */
@@ -0,0 +1,217 @@
+// utf-8 (ü)
+
+// MIT License
+// Copyright © 2023 Olaf Simon
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+/**
+ * @file   cTimeColumns.cpp
+ * @author Olaf Simon
+ * @brief  Column wise (batch) calendar conversion of class LibCpp::cTime
+ *
+ * \addtogroup LibCpp_time
+ * @{
+ *
+ * Converting large amounts of unix times (e.g. a column of a data base table or a log file)
+ * one by one with cTime::calendar() packs each result into a stCalendar struct. Typical
+ * evaluations need single entries like the hour or the day of all values. cTime::calendarColumns()
+ * writes each calendar entry to its own array (structure of arrays).
+ *
+ * \code
+ * std::vector<time_t>  times = ...;
+ * std::vector<int32_t> years(times.size());
+ * std::vector<uint8_t> hours(times.size());
+ * stCalendarColumns columns = stCalendarColumns_Ini;
+ * columns.year = years.data();
+ * columns.hour = hours.data();
+ * cTime::calendarColumns(times.data(), times.size(), columns);  // UTC
+ * \endcode
+ *
+ * The values are converted in blocks. All integer calculations of a block are done on 32 bit
+ * lanes without branches or table look ups, thus the compiler vectorizes the loops. On x86-64 a
+ * second instance of the kernel is compiled for AVX2 and selected at run time if the processor
+ * supports it, the SSE2 instance is the fallback.
+ *
+ * The range of day numbers is limited to 32 bit, thus unix times of about +-5 million years are supported.
+**/
+
+#include "cTime.h"
+#include "cCalendarMath.h"
+
+#include <cstring>
+
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC optimize ("O3")                                 // -O2 of gcc does not vectorize loops needing an epilogue
+#endif
+
+using namespace LibCpp;
+
+#define LibCpp_COLUMNBLOCK     256                              ///< Values converted per block
+#define LibCpp_BLOCKSHIFT      14000                            ///< 400 year blocks added to the day number to receive unsigned values
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define LibCpp_COLUMNS_AVX2                                 ///< Compile an additional AVX2 kernel
+    #define LibCpp_ALWAYSINLINE __attribute__((always_inline))  ///< Forces the kernel into each target specific instance
+#else
+    #define LibCpp_ALWAYSINLINE
+#endif
+
+const stCalendarColumns LibCpp::stCalendarColumns_Ini = {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr}; ///< Initializer for stCalendarColumns
+
+/**
+ * @brief Converts one block of unix times to calendar data columns.
+ * The calculation follows cTime::civilFromDays() but replaces the branches by selections and the
+ * month table by the closed formula of the month beginnings (367 * month - 362) / 12 of a year
+ * having 30 days in february.
+ * @param pUnixTimes Unix times of the block.
+ * @param count Number of values, at most LibCpp_COLUMNBLOCK.
+ * @param offset Zone offset in seconds.
+ * @param columns Destination, already advanced to the block.
+ */
+static LibCpp_ALWAYSINLINE inline void calendarBlock(const time_t* pUnixTimes, size_t count, int64_t offset, const stCalendarColumns& columns)
+{
+    uint32_t days[LibCpp_COLUMNBLOCK];
+    uint32_t seconds[LibCpp_COLUMNBLOCK];
+    int32_t  year[LibCpp_COLUMNBLOCK];
+    uint8_t  month[LibCpp_COLUMNBLOCK];
+    uint8_t  day[LibCpp_COLUMNBLOCK];
+    uint8_t  hour[LibCpp_COLUMNBLOCK];
+    uint8_t  minute[LibCpp_COLUMNBLOCK];
+    uint8_t  second[LibCpp_COLUMNBLOCK];
+    uint8_t  dayInWeek[LibCpp_COLUMNBLOCK];
+    uint16_t dayInYear[LibCpp_COLUMNBLOCK];
+
+    // Days relative to 1.1.2001 shifted to positive values, and seconds of the day.
+    // The low 32 bits of the remainder are exact, thus the correction is done on 32 bit.
+    for (size_t n=0; n<count; n++)
+    {
+        int64_t value = (int64_t)pUnixTimes[n] + offset;
+        int32_t d = (int32_t)(value / LibCpp_SECONDSPERDAY);
+        int32_t s = (int32_t)((uint32_t)value - (uint32_t)d * LibCpp_SECONDSPERDAY);
+        d -= (s < 0);
+        s += (s < 0) * LibCpp_SECONDSPERDAY;
+        days[n] = (uint32_t)(d - LibCpp_DAYS1970TO2001) + (uint32_t)LibCpp_BLOCKSHIFT * LibCpp_DAYSPER400YEARS;
+        seconds[n] = (uint32_t)s;
+    }
+
+    for (size_t n=0; n<count; n++)
+    {
+        uint32_t z = days[n];
+        uint32_t k = z / LibCpp_DAYSPER400YEARS;
+        uint32_t r = z - k * LibCpp_DAYSPER400YEARS;
+        uint32_t j = r / LibCpp_DAYSPER100YEARS;
+        j -= (j == 4);
+        r -= j * LibCpp_DAYSPER100YEARS;
+        uint32_t i = r / LibCpp_DAYSPER4YEARS;
+        r -= i * LibCpp_DAYSPER4YEARS;
+        uint32_t h = r / 365;
+        h -= (h == 4);
+        r -= h * 365;
+        uint32_t leap = (h == 3) & ((i != 24) | (j == 3));
+        uint32_t r30 = r + (r >= 59 + leap) * (2 - leap);      // day of a year having 30 days in february
+        uint32_t m = (12 * r30 + 373) / 367;
+        uint32_t s = seconds[n];
+
+        year[n]      = (int32_t)(k * 400 + j * 100 + i * 4 + h) + (2001 - LibCpp_BLOCKSHIFT * 400);
+        month[n]     = (uint8_t)m;
+        day[n]       = (uint8_t)(r30 - (367 * m - 362) / 12 + 1);
+        dayInYear[n] = (uint16_t)(r + 1);
+        dayInWeek[n] = (uint8_t)(z % 7 + 1);                    // 1.1.2001 was a monday
+        hour[n]      = (uint8_t)(s / 3600);
+        minute[n]    = (uint8_t)(s / 60 % 60);
+        second[n]    = (uint8_t)(s % 60);
+    }
+
+    if (columns.year)      memcpy(columns.year,      year,      count * sizeof(int32_t));
+    if (columns.month)     memcpy(columns.month,     month,     count);
+    if (columns.day)       memcpy(columns.day,       day,       count);
+    if (columns.hour)      memcpy(columns.hour,      hour,      count);
+    if (columns.minute)    memcpy(columns.minute,    minute,    count);
+    if (columns.second)    memcpy(columns.second,    second,    count);
+    if (columns.dayInWeek) memcpy(columns.dayInWeek, dayInWeek, count);
+    if (columns.dayInYear) memcpy(columns.dayInYear, dayInYear, count * sizeof(uint16_t));
+}
+
+/**
+ * @brief Advances all column pointers by 'count' elements.
+ * @param columns
+ * @param count
+ * @return Advanced columns
+ */
+static inline stCalendarColumns advanceColumns(stCalendarColumns columns, size_t count)
+{
+    if (columns.year)      columns.year      += count;
+    if (columns.month)     columns.month     += count;
+    if (columns.day)       columns.day       += count;
+    if (columns.hour)      columns.hour      += count;
+    if (columns.minute)    columns.minute    += count;
+    if (columns.second)    columns.second    += count;
+    if (columns.dayInWeek) columns.dayInWeek += count;
+    if (columns.dayInYear) columns.dayInYear += count;
+    return columns;
+}
+
+/**
+ * @brief Generic (SSE2 on x86-64) instance of the conversion.
+ */
+static void calendarColumnsGeneric(const time_t* pUnixTimes, size_t count, stCalendarColumns columns, int64_t offset)
+{
+    for (size_t n=0; n<count; n+=LibCpp_COLUMNBLOCK)
+    {
+        size_t blockSize = count - n < LibCpp_COLUMNBLOCK ? count - n : LibCpp_COLUMNBLOCK;
+        calendarBlock(pUnixTimes + n, blockSize, offset, advanceColumns(columns, n));
+    }
+}
+
+#ifdef LibCpp_COLUMNS_AVX2
+/**
+ * @brief AVX2 instance of the conversion.
+ */
+__attribute__((target("avx2"))) static void calendarColumnsAVX2(const time_t* pUnixTimes, size_t count, stCalendarColumns columns, int64_t offset)
+{
+    for (size_t n=0; n<count; n+=LibCpp_COLUMNBLOCK)
+    {
+        size_t blockSize = count - n < LibCpp_COLUMNBLOCK ? count - n : LibCpp_COLUMNBLOCK;
+        calendarBlock(pUnixTimes + n, blockSize, offset, advanceColumns(columns, n));
+    }
+}
+#endif
+
+/**
+ * @brief Converts an array of unix times to calendar data columns within a fixed zone.
+ * The result equals cTime::unixToCalendar() for each value, the zone is not taken from the system clock settings.
+ * @param pUnixTimes Array of unix times.
+ * @param count Number of values.
+ * @param columns Destination arrays, see \ref _stCalendarColumns. Entries set to zero are not written.
+ * @param zone Geographic time zone (dst = 0 or 1) or UTC relative time zone (dst = -1).
+ * @param dst
+ */
+void cTime::calendarColumns(const time_t* pUnixTimes, size_t count, stCalendarColumns columns, stTimeZone zone, int8_t dst)
+{
+    int64_t offset = zoneOffset(zone, dst);
+#ifdef LibCpp_COLUMNS_AVX2
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    if (avx2)
+    {
+        calendarColumnsAVX2(pUnixTimes, count, columns, offset);
+        return;
+    }
+#endif
+    calendarColumnsGeneric(pUnixTimes, count, columns, offset);
+}
+
+/** @} */
@@ -0,0 +1,505 @@
+// utf-8 (ü)
+/**
+ * @file   cTimeFormat.h
+ * @author Olaf Simon
+ * @brief  Header only, compile time format strings for cTime::toString
+ *
+ * \addtogroup LibCpp_time
+ * @{
+ *
+ * A format string wrapped by LibCpp_TIMEFORMAT is a type. Its format symbols (see \ref TIME_FORMATTING) are
+ * checked by the compiler, an unknown symbol is a compile error. The formatting code is generated per
+ * format as a straight sequence of copies of the literal text and of the numbers, no format string
+ * is interpreted at run time.
+ * \code
+ * auto isoFormat = LibCpp_TIMEFORMAT("%Y-%m-%d %H:%M:%S");
+ * std::string text = cTime::toString(calendar, isoFormat);
+ *
+ * char buffer[LibCpp::timeFormat::length<decltype(isoFormat)> + 1];   // exactly 19 + 1 characters
+ * LibCpp::timeFormat::format(buffer, calendar, isoFormat);
+ * \endcode
+ * The result equals cTime::toString(calendar, "%Y-%m-%d %H:%M:%S"). The names of '%a', '%A', '%b', '%B' and '%Z'
+ * are written by LibOb_strftime().
+**/
+
+#ifndef cTimeFormat_H
+#define cTimeFormat_H
+
+#include <string.h>
+#include <utility>
+
+#include "cTime.h"
+
+/**
+ * @brief Turns a string literal into a compile time format type for cTime::toString and LibCpp::timeFormat::format.
+ * An empty string is the default format LibOb_DEFAULTFORMAT.
+ */
+#define LibCpp_TIMEFORMAT(text) [] { struct stTimeFormat_ { static constexpr bool isTimeFormat() { return true; } static constexpr const char* value() { return text; } }; return stTimeFormat_{}; }()
+
+#if defined(__GNUC__)
+    #define LibCpp_FORMATINLINE __attribute__((always_inline)) inline     ///< Folds the symbol switch into each step of a compile time format
+#else
+    #define LibCpp_FORMATINLINE inline
+#endif
+
+namespace LibCpp
+{
+
+namespace timeFormat
+{
+
+/**
+ * @brief One step of a compile time format.
+ */
+struct stFormatStep
+{
+    char     symbol;        ///< Format symbol, 0 for literal text
+    uint8_t  modifier;      ///< Length modifier 1 or 2 ('%1m') or number of digits 1-9 of a fraction ('%3f'), 0 if not given
+    uint16_t begin;         ///< Index of the literal text within the format string
+    uint16_t length;        ///< Number of literal characters
+};
+
+/**
+ * @brief Steps of a compile time format.
+ */
+template <size_t N> struct stFormatSteps
+{
+    stFormatStep steps[N ? N : 1];     ///< steps
+};
+
+/**
+ * Two digit strings "00" to "99" for number formatting
+ */
+inline constexpr char DIGITPAIRS[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/**
+ * @brief Format string of a format type, the default format for an empty string.
+ * @return Format string
+ */
+template <typename F> constexpr const char* text()
+{
+    return *F::value() ? F::value() : LibOb_DEFAULTFORMAT;
+}
+
+/**
+ * @brief Checks a format symbol being supported.
+ * @param symbol
+ * @return true if known
+ */
+constexpr bool isSymbol(char symbol)
+{
+    switch (symbol)
+    {
+    case 'Y': case 'y': case 'm': case 'b': case 'B': case 'e': case 'd': case 'H': case 'I': case 'p':
+    case 'M': case 'S': case 'f': case 'U': case 'z': case 'Z': case 'a': case 'A': case 'j': case '%':
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Checks a format symbol being a name written by LibOb_strftime (needs the struct tm).
+ * @param symbol
+ * @return true for '%a', '%A', '%b', '%B' and '%Z'
+ */
+constexpr bool isName(char symbol)
+{
+    return symbol == 'a' || symbol == 'A' || symbol == 'b' || symbol == 'B' || symbol == 'Z';
+}
+
+/**
+ * @brief Checks all format symbols of a format string (each '%' followed by an optional '1' or '2' and a known symbol,
+ * or by an optional digit '1' to '9' and 'f').
+ * @param format
+ * @return true if the format is valid
+ */
+constexpr bool isValid(const char* format)
+{
+    while (*format)
+    {
+        if (*format++ != '%') continue;
+        if (*format == '1' || *format == '2') format++;
+        else if (*format >= '3' && *format <= '9' && format[1] == 'f') format++;
+        if (!isSymbol(*format)) return false;
+        format++;
+    }
+    return true;
+}
+
+/**
+ * @brief Number of steps (literal runs and symbols) of a format string.
+ * @param format
+ * @return Number of steps
+ */
+constexpr size_t countSteps(const char* format)
+{
+    size_t count = 0;
+    while (*format)
+    {
+        if (*format == '%')
+        {
+            format++;
+            if (*format >= '1' && *format <= '9') format++;
+            if (*format) format++;
+        }
+        else
+            while (*format && *format != '%') format++;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Splits a format string into literal runs and symbols.
+ * @param format
+ * @return Steps
+ */
+template <size_t N> constexpr stFormatSteps<N> compile(const char* format)
+{
+    stFormatSteps<N> result = {};
+    const char* position = format;
+    size_t n = 0;
+    while (*position)
+    {
+        stFormatStep step = {0, 0, 0, 0};
+        if (*position == '%')
+        {
+            position++;
+            if (*position >= '1' && *position <= '9') step.modifier = (uint8_t)(*position++ - '0');
+            step.symbol = *position;
+            if (*position) position++;
+        }
+        else
+        {
+            step.begin = (uint16_t)(position - format);
+            while (*position && *position != '%') position++;
+            step.length = (uint16_t)(position - format - step.begin);
+        }
+        result.steps[n++] = step;
+    }
+    return result;
+}
+
+/**
+ * @brief Number of characters of a step for calendar data within the documented ranges (years 0 to 9999).
+ * @param step
+ * @return Number of characters, 0 if the length depends on the value.
+ */
+constexpr size_t fixedLength(stFormatStep step)
+{
+    switch (step.symbol)
+    {
+    case 0:   return step.length;
+    case 'Y': return 4;
+    case 'y': return 2;
+    case 'm': case 'd': case 'H': case 'I': case 'M': case 'S':
+              return (step.modifier == 1) ? 0 : 2;
+    case 'f': return step.modifier ? step.modifier : 6;
+    case 'p': return 2;
+    case 'U': return 3;
+    case 'z': return 6;
+    case '%': return 1;
+    default:  return 0;
+    }
+}
+
+/**
+ * @brief Maximum number of characters of a step for any calendar data.
+ * @param step
+ * @return Number of characters
+ */
+constexpr size_t maximumLength(stFormatStep step)
+{
+    switch (step.symbol)
+    {
+    case 0:   return step.length;
+    case 'Y': return 11;
+    case 'y': return 3;
+    case 'j': return 5;
+    case 'm': case 'd': case 'e': case 'H': case 'I': case 'M': case 'S':
+              return 3;
+    case 'f': return step.modifier ? step.modifier : 6;
+    case 'p': return 2;
+    case 'U': return 3;
+    case 'z': return 8;
+    case '%': return 1;
+    default:  return 31;    // names, see LibOb_strftime
+    }
+}
+
+template <typename F> inline constexpr size_t stepCount = countSteps(text<F>());                          ///< Number of steps of format F
+template <typename F> inline constexpr stFormatSteps<stepCount<F>> program = compile<stepCount<F>>(text<F>()); ///< Steps of format F
+
+/**
+ * @brief Sums the lengths of all steps.
+ * @param fixed If set the fixed lengths are summed, otherwise the maximum lengths.
+ * @return Length, 0 if 'fixed' is set and any step has no fixed length.
+ */
+template <typename F> constexpr size_t sumLength(bool fixed)
+{
+    size_t sum = 0;
+    for (size_t n=0; n<stepCount<F>; n++)
+    {
+        size_t length = fixed ? fixedLength(program<F>.steps[n]) : maximumLength(program<F>.steps[n]);
+        if (length == 0 && program<F>.steps[n].symbol != 0) return 0;
+        sum += length;
+    }
+    return sum;
+}
+
+/**
+ * @brief Checks a format needing the struct tm of LibOb_strftime (names).
+ * @return true if a name is formatted
+ */
+template <typename F> constexpr bool needsTm()
+{
+    for (size_t n=0; n<stepCount<F>; n++)
+        if (isName(program<F>.steps[n].symbol)) return true;
+    return false;
+}
+
+template <typename F> inline constexpr size_t length = sumLength<F>(true);       ///< Length of the result of format F for calendar data within the documented ranges (years 0 to 9999), 0 if the length depends on the values (e.g. names).
+template <typename F> inline constexpr size_t maxLength = sumLength<F>(false);   ///< Maximum length of the result of format F (without termination).
+
+/**
+ * @brief Writes an unsigned number with at least 'width' digits (leading zeros).
+ * @param destination
+ * @param value
+ * @param width Minimum number of digits (2 and 4 are fast paths)
+ * @return Position behind the number
+ */
+inline char* printUint(char* destination, unsigned int value, int width)
+{
+    if (width == 2 && value < 100)
+    {
+        memcpy(destination, DIGITPAIRS + 2*value, 2);
+        return destination + 2;
+    }
+    if (width == 4 && value < 10000)
+    {
+        memcpy(destination, DIGITPAIRS + 2*(value / 100), 2);
+        memcpy(destination + 2, DIGITPAIRS + 2*(value % 100), 2);
+        return destination + 4;
+    }
+    char digits[16];
+    char* position = digits + 16;
+    do
+    {
+        *--position = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (digits + 16 - position < width)
+        *--position = '0';
+    memcpy(destination, position, (size_t)(digits + 16 - position));
+    return destination + (digits + 16 - position);
+}
+
+/**
+ * @brief Divisor of the nano seconds to receive a fraction of the given number of digits.
+ * @param digits 1-9
+ * @return 10 to the power of (9 - digits)
+ */
+constexpr unsigned int fractionDivisor(int digits)
+{
+    unsigned int divisor = 1;
+    for (int n=digits; n<9; n++)
+        divisor *= 10;
+    return divisor;
+}
+
+/**
+ * @brief Writes an integer with at least 'width' characters including the sign.
+ * @param destination
+ * @param value
+ * @param width
+ * @param plus If set, positive values are written with '+'.
+ * @return Position behind the number
+ */
+inline char* printInt(char* destination, int value, int width, bool plus)
+{
+    if (value < 0)
+    {
+        *destination = '-';
+        return printUint(destination + 1, 0u - (unsigned int)value, width - 1);
+    }
+    if (plus)
+    {
+        *destination = '+';
+        return printUint(destination + 1, (unsigned int)value, width - 1);
+    }
+    return printUint(destination, (unsigned int)value, width);
+}
+
+/**
+ * @brief Writes one format symbol of calendar data, the numbers are written directly from the calendar entries.
+ * Shared by the compile time formats and the run time formatter cTime::format().
+ * @param destination Buffer of at least maximumLength() of the symbol (32 characters for names).
+ * @param symbol Format symbol
+ * @param modifier Length modifier 1 or 2 or number of digits of '%f', 0 if not given.
+ * @param calendar
+ * @param pTm struct tm and time zone of the calendar, only used for names (see isName()).
+ * If zero, they are built from the calendar for each name.
+ * @param pZone
+ * @param pLanguage
+ * @return Position behind the written characters, zero if the symbol is unknown (see isSymbol())
+ */
+LibCpp_FORMATINLINE char* formatSymbol(char* destination, char symbol, uint8_t modifier, const stCalendar& calendar, const struct tm* pTm, stTimeZone* pZone, enLanguage* pLanguage)
+{
+    const int width = (modifier == 1) ? 1 : 2;
+    switch (symbol)
+    {
+    case 'Y':
+        if (calendar.year == INT32_INVALID) return destination;
+        return printInt(destination, calendar.year, 4, false);
+    case 'y':
+        if (calendar.year == INT32_INVALID) return destination;
+        return printInt(destination, calendar.year % 100, 2, false);
+    case 'm':
+        if (calendar.month == UINT8_INVALID) return destination;
+        return printUint(destination, calendar.month, width);
+    case 'd':
+        if (calendar.day == UINT8_INVALID) return destination;
+        return printUint(destination, calendar.day, width);
+    case 'e':
+        if (calendar.day == UINT8_INVALID) return destination;
+        return printUint(destination, calendar.day, 1);
+    case 'H':
+        if (calendar.hour == UINT8_INVALID) return destination;
+        return printUint(destination, calendar.hour, width);
+    case 'I':
+        if (calendar.hour == UINT8_INVALID) return destination;
+        return printUint(destination, (calendar.hour > 12) ? calendar.hour % 12 : calendar.hour, width);
+    case 'p':
+        if (calendar.hour == UINT8_INVALID) return destination;
+        memcpy(destination, (calendar.hour >= 12) ? "PM" : "AM", 2);
+        return destination + 2;
+    case 'M':
+        if (calendar.minute == UINT8_INVALID) return destination;
+        return printUint(destination, calendar.minute, width);
+    case 'S':
+        if (calendar.second == UINT8_INVALID) return destination;
+        return printUint(destination, calendar.second, width);
+    case 'f':
+    {
+        const int digits = modifier ? modifier : 6;
+        if (calendar.nanoSeconds >= 1000000000u) return destination;
+        return printUint(destination, calendar.nanoSeconds / fractionDivisor(digits), digits);
+    }
+    case 'j':
+        if (calendar.dayInYear == UINT16_INVALID) return destination;
+        return printUint(destination, calendar.dayInYear, 1);
+    case 'U':
+        if (calendar.dst < -1 || calendar.dst > 1) return destination;
+        memcpy(destination, "UTCSTDDST" + 3*(calendar.dst + 1), 3);     // dstNames of LibOb_strftime
+        return destination + 3;
+    case 'z':
+        if (calendar.timeZone.hours == INT8_INVALID) return destination;
+        destination = printInt(destination, calendar.timeZone.hours, 3, true);
+        *destination++ = ':';
+        return printUint(destination, calendar.timeZone.minutes, 2);
+    case '%':
+        *destination = '%';
+        return destination + 1;
+    case 'a': case 'A': case 'b': case 'B': case 'Z':
+    {
+        const char format[3] = {'%', symbol, 0};
+        if (pTm) return destination + LibOb_strftime(destination, 32, format, pTm, pZone, pLanguage);
+        stTimeZone zone = stTimeZone_Invalid;
+        struct tm t = cTime::fromCalendar(calendar, &zone);
+        return destination + LibOb_strftime(destination, 32, format, &t, &zone, pLanguage);
+    }
+    default:
+        return nullptr;
+    }
+}
+
+/**
+ * @brief Executes step I of format F.
+ * @param destination
+ * @param calendar
+ * @param pTm struct tm of the calendar if needsTm<F>()
+ * @param pZone Time zone of the calendar if needsTm<F>()
+ * @param pLanguage
+ * @return Position behind the written characters
+ */
+template <typename F, size_t I> inline char* formatStep(char* destination, const stCalendar& calendar, const struct tm* pTm, stTimeZone* pZone, enLanguage* pLanguage)
+{
+    constexpr stFormatStep step = program<F>.steps[I];
+    if constexpr (step.symbol == 0)
+    {
+        memcpy(destination, text<F>() + step.begin, step.length);
+        return destination + step.length;
+    }
+    else
+        return formatSymbol(destination, step.symbol, step.modifier, calendar, pTm, pZone, pLanguage);
+}
+
+/**
+ * @brief Executes all steps of format F.
+ * @return Position behind the written characters
+ */
+template <typename F, size_t... I> inline char* formatSteps(char* destination, const stCalendar& calendar, const struct tm* pTm, stTimeZone* pZone, enLanguage* pLanguage, std::index_sequence<I...>)
+{
+    ((destination = formatStep<F, I>(destination, calendar, pTm, pZone, pLanguage)), ...);
+    return destination;
+}
+
+/**
+ * @brief Formats calendar data with a compile time format.
+ * Same result as cTime::toString(calendar, format) for the format string of F.
+ * @param destination Buffer of at least maxLength<F> + 1 characters (length<F> + 1 for calendar data within the documented ranges).
+ * @param calendar
+ * @param format Format type, see LibCpp_TIMEFORMAT.
+ * @param pLanguage Language of names.
+ * @return Number of characters written (without termination)
+ */
+template <typename F> inline size_t format(char* destination, const stCalendar& calendar, F format = F{}, enLanguage* pLanguage = &LibOb_GLOBALLANGUAGE)
+{
+    static_assert(isValid(text<F>()), "Unknown format symbol, see LibOb_strftime");
+    (void)format;
+    struct tm t;
+    stTimeZone zone = stTimeZone_Invalid;
+    if constexpr (needsTm<F>())
+        t = cTime::fromCalendar(calendar, &zone);
+    char* end = formatSteps<F>(destination, calendar, &t, &zone, pLanguage, std::make_index_sequence<stepCount<F>>{});
+    *end = 0;
+    return (size_t)(end - destination);
+}
+
+}
+
+/**
+ * @brief Generates a \ref GZC formatted string from a calendar struct using a compile time format.
+ * @param calendar
+ * @param format Format type, see LibCpp_TIMEFORMAT.
+ * @param pLanguage
+ * @return Formatted string
+ */
+template <typename F, typename> std::string cTime::toString(stCalendar calendar, F format, enLanguage* pLanguage)
+{
+    char buffer[timeFormat::maxLength<F> + 1];
+    size_t length = timeFormat::format(buffer, calendar, format, pLanguage);
+    return std::string(buffer, length);
+}
+
+/**
+ * @brief Returns a string interpretation of the 'calendar' method result using a compile time format.
+ * @param format Format type, see LibCpp_TIMEFORMAT.
+ * @param pLanguage
+ * @param pRequestedTimeZone See calendar().
+ * @return Formatted string
+ */
+template <typename F, typename> std::string cTime::toString(F format, enLanguage* pLanguage, int8_t* pRequestedTimeZone)
+{
+    return toString(calendar(pRequestedTimeZone), format, pLanguage);
+}
+
+}
+
+#endif // cTimeFormat_H
+
+/** @} */
@@ -0,0 +1,360 @@
+// utf-8 (ü)
+
+// MIT License
+// Copyright © 2023 Olaf Simon
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+/**
+ * @file   cTimeScan.cpp
+ * @author Olaf Simon
+ * @brief  Fast conversion of character strings to unix time of class LibCpp::cTime
+ *
+ * \addtogroup LibCpp_time
+ * @{
+ *
+ * The general string conversion cTime::fromString() accepts a large variety of calendar strings
+ * (see LibOb_strptime). Strings written by cTime::toString() with the default format have a fixed
+ * layout, which is checked and converted in a single step by cTime::scanGZC().
+ *
+ * \code
+ * time_t value;
+ * if (cTime::scanGZC("2023-09-20#17:17:38#DST#+01:00", &value))
+ *     printf("%lld\n", (long long)value);  // 1695223058
+ * \endcode
+ *
+ * On processors providing SSE2 (any x86-64) all 30 characters are checked and the digits are
+ * converted within two 16 byte registers. Other processors use the equivalent scalar code.
+ *
+ * Strings of other numeric formats are converted by cTime::scan() in a single pass: the fields are
+ * accumulated as integers and the unix time is calculated by calendarMath::daysFromCivil() and the
+ * parsed zone and dst, or the cached offsets of the local zone. Neither struct tm nor stCalendar are involved.
+ * \code
+ * time_t value;
+ * uint32_t nanoSeconds;
+ * if (cTime::scan(pLine, 23, "%Y-%m-%d %H:%M:%3f", &value, &nanoSeconds))    // local zone
+ *     ...
+ * \endcode
+**/
+
+#include "cTime.h"
+#include "cCalendarMath.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define LibCpp_GZC_SSE2     ///< Use SSE2 for checking and converting GZC strings
+#endif
+
+using namespace LibCpp;
+
+static const char GZCPATTERN[32] = "0000-00-00#00:00:00#DST#+00:00";  ///< Layout of a GZC string, the literal characters are checked
+
+#define LibCpp_GZCDIGITS_LO   0xDB6F        ///< Digit positions 0-3, 5-6, 8-9, 11-12, 14-15
+#define LibCpp_GZCLITERALS_LO 0x2490        ///< Literal positions 4, 7, 10, 13
+#define LibCpp_GZCDIGITS_HI   0x3606        ///< Digit positions 17-18, 25-26, 28-29 (bits relative to position 16)
+#define LibCpp_GZCLITERALS_HI 0x0889        ///< Literal positions 16, 19, 23, 27 (bits relative to position 16)
+#define LibCpp_SCANYEARDIGITS 4             ///< Maximum number of digits of the '%Y' field of cTime::scan()
+#define LibCpp_SCANDIGITS     2             ///< Maximum number of digits of the other numeric fields of cTime::scan()
+#define LibCpp_SCANCOMPLETE   0x3F          ///< Flags of cTime::scan() for year, month, day, hour, minute and second
+
+/**
+ * @brief Converts a \ref GZC string of the fixed layout "2023-09-20#17:17:38#DST#+01:00" to unix time.
+ * The dst code may be 'UTC', 'STD' or 'DST' and the zone sign '+' or '-'. Any other deviation from
+ * the layout (e.g. a zone abbreviation or missing leading zeros) fails. In this case use cTime::fromString(),
+ * which accepts any calendar string.\n
+ * No library functions are called, the zone of the string is used (not the local zone).
+ * @param source String to be converted, at least 30 characters are read unless the string ends before.
+ * @param pUnixTime Resulting unix time [output]
+ * @return Pointer to the character following the GZC string or zero if the layout does not match.
+ */
+const char* cTime::scanGZC(const char* source, time_t* pUnixTime)
+{
+    char buffer[32];
+    if (!source) return 0;
+    for (int i=0; i<LibCpp_GZCLENGTH; i++)
+    {
+        if (!source[i]) return 0;
+        buffer[i] = source[i];
+    }
+    buffer[30] = 0;
+    buffer[31] = 0;
+
+    unsigned int year, month, day, hour, minute, second, zoneHours, zoneMinutes;
+#ifdef LibCpp_GZC_SSE2
+    const __m128i zero    = _mm_set1_epi8('0');
+    const __m128i nine    = _mm_set1_epi8(9);
+    const __m128i low     = _mm_set1_epi16(0x00FF);
+    const __m128i ten     = _mm_set1_epi16(10);
+    __m128i textLo  = _mm_loadu_si128((const __m128i*)buffer);
+    __m128i textHi  = _mm_loadu_si128((const __m128i*)(buffer + 16));
+    __m128i digitLo = _mm_sub_epi8(textLo, zero);
+    __m128i digitHi = _mm_sub_epi8(textHi, zero);
+
+    // digits: (unsigned)(character - '0') <= 9, literals: equal to the pattern
+    int isDigitLo   = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(digitLo, nine), nine));
+    int isDigitHi   = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(digitHi, nine), nine));
+    int isLiteralLo = _mm_movemask_epi8(_mm_cmpeq_epi8(textLo, _mm_loadu_si128((const __m128i*)GZCPATTERN)));
+    int isLiteralHi = _mm_movemask_epi8(_mm_cmpeq_epi8(textHi, _mm_loadu_si128((const __m128i*)(GZCPATTERN + 16))));
+    if ((isDigitLo & LibCpp_GZCDIGITS_LO) != LibCpp_GZCDIGITS_LO || (isLiteralLo & LibCpp_GZCLITERALS_LO) != LibCpp_GZCLITERALS_LO ||
+        (isDigitHi & LibCpp_GZCDIGITS_HI) != LibCpp_GZCDIGITS_HI || (isLiteralHi & LibCpp_GZCLITERALS_HI) != LibCpp_GZCLITERALS_HI)
+        return 0;
+
+    // Two digit numbers as 16 bit lanes: 10 * first + second. 'odd' holds the numbers starting at odd positions.
+    __m128i evenLo = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(digitLo, low), ten), _mm_srli_epi16(digitLo, 8));
+    __m128i shift  = _mm_srli_si128(digitLo, 1);
+    __m128i oddLo  = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(shift, low), ten), _mm_srli_epi16(shift, 8));
+    __m128i evenHi = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(digitHi, low), ten), _mm_srli_epi16(digitHi, 8));
+    shift          = _mm_srli_si128(digitHi, 1);
+    __m128i oddHi  = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(shift, low), ten), _mm_srli_epi16(shift, 8));
+    year        = (unsigned int)_mm_extract_epi16(evenLo, 0) * 100 + (unsigned int)_mm_extract_epi16(evenLo, 1);
+    month       = (unsigned int)_mm_extract_epi16(oddLo, 2);
+    day         = (unsigned int)_mm_extract_epi16(evenLo, 4);
+    hour        = (unsigned int)_mm_extract_epi16(oddLo, 5);
+    minute      = (unsigned int)_mm_extract_epi16(evenLo, 7);
+    second      = (unsigned int)_mm_extract_epi16(oddHi, 0);
+    zoneHours   = (unsigned int)_mm_extract_epi16(oddHi, 4);
+    zoneMinutes = (unsigned int)_mm_extract_epi16(evenHi, 6);
+#else
+    for (int i=0; i<LibCpp_GZCLENGTH; i++)
+    {
+        if (GZCPATTERN[i] == '0')
+        {
+            if ((unsigned char)(buffer[i] - '0') > 9) return 0;
+            buffer[i] -= '0';
+        }
+        else if (i != 20 && i != 21 && i != 22 && i != 24 && buffer[i] != GZCPATTERN[i])
+            return 0;
+    }
+    year        = buffer[0] * 1000u + buffer[1] * 100u + buffer[2] * 10u + buffer[3];
+    month       = buffer[5]  * 10u + buffer[6];
+    day         = buffer[8]  * 10u + buffer[9];
+    hour        = buffer[11] * 10u + buffer[12];
+    minute      = buffer[14] * 10u + buffer[15];
+    second      = buffer[17] * 10u + buffer[18];
+    zoneHours   = buffer[25] * 10u + buffer[26];
+    zoneMinutes = buffer[28] * 10u + buffer[29];
+#endif
+
+    int32_t offset = (int32_t)(zoneHours * 3600 + zoneMinutes * 60);
+    if (buffer[24] == '-')
+    {
+        if (zoneHours == 0 && zoneMinutes != 0) return 0;   // "-00:30" has no stTimeZone, left to cTime::fromString()
+        offset = -offset;
+    }
+    else if (buffer[24] != '+')
+        return 0;
+    if (buffer[20] == 'D' && buffer[21] == 'S' && buffer[22] == 'T')
+        offset += 3600;
+    else if (!((buffer[20] == 'S' && buffer[21] == 'T' && buffer[22] == 'D') || (buffer[20] == 'U' && buffer[21] == 'T' && buffer[22] == 'C')))
+        return 0;
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 59 || zoneHours > 14 || zoneMinutes > 59)
+        return 0;
+
+    int64_t days = calendarMath::daysFromCivil(year, month, day);
+    *pUnixTime = (time_t)(days * LibCpp_SECONDSPERDAY + hour * LibCpp_SECONDSPERHOUR + minute * LibCpp_SECONDSPERMINUTE + second - offset);
+    return source + LibCpp_GZCLENGTH;
+}
+
+/**
+ * @brief Scans the digits of a numeric field of cTime::scan().
+ * @param source
+ * @param sourceEnd
+ * @param maxDigits Width of the field, a longer digit run fails.
+ * @param pValue [output]
+ * @return Pointer behind the digits, zero if there is no digit or more than maxDigits.
+ */
+static const char* scanNumber(const char* source, const char* sourceEnd, int maxDigits, unsigned int* pValue)
+{
+    const char* begin = source;
+    unsigned int value = 0;
+    while (source < sourceEnd && (unsigned char)(*source - '0') <= 9)
+    {
+        if (source - begin == maxDigits) return 0;
+        value = value * 10 + (unsigned int)(*source++ - '0');
+    }
+    if (source == begin) return 0;
+    *pValue = value;
+    return source;
+}
+
+/**
+ * @brief Converts a numeric calendar string to unix time in a single pass.
+ * The fields are accumulated as integers and converted by calendarMath::daysFromCivil() and the parsed
+ * zone ('%z') and dst ('%U'). Without a zone the string is taken as wall clock time of the local zone
+ * (see calendar()). No struct tm or stCalendar is filled, mktime is only called for a local wall clock time
+ * the cached zone context cannot resolve (see localToUnix()).\n
+ * The format must contain the year ('%Y' or '%y'), month, day ('%d' or '%e'), hour ('%H'), minute and second.
+ * Further symbols are '%f', '%U' and '%z', length modifiers are ignored like LibOb_strptime does. The literal
+ * text must match exactly and each field must start with a digit. The year has at most 4 digits, the other
+ * fields at most 2 ('%z' as "+HHMM" or "+H:MM") and each value must be within its range (the day within
+ * the month, no leap second). Anything else (names, '%I', '%p', '%Z', leading blanks, over-wide or out of
+ * range fields, a source ending before the format, an empty format) fails, in this case use
+ * cTime::fromString(), which normalizes such fields in its own way.
+ * A string with a zone has the same unix time as cTime::set(fromString(source, format)). A string without zone
+ * is the inverse of calendar() and equals mktime, apart from the hour repeated at the end of the dst, where
+ * the earlier instant is taken (see localToUnix()).
+ * @param source Characters to be converted, at most 'sourceLength' characters are read.
+ * @param sourceLength
+ * @param format See \ref TIME_FORMATTING, an empty string (automatic scan of fromString()) fails.
+ * @param pUnixTime Resulting unix time [output]
+ * @param pNanoSeconds Resulting nano seconds after the unix time (0 without '%f') [output], may be zero.
+ * @return Pointer to the character following the converted characters or zero if the format does not match.
+ */
+const char* cTime::scan(const char* source, size_t sourceLength, const char* format, time_t* pUnixTime, uint32_t* pNanoSeconds)
+{
+    if (!source || !format || !pUnixTime) return 0;
+    if (*format == 0) return 0;     // the automatic scan is left to LibOb_strptime
+    const char* end = source + sourceLength;
+    int32_t year = 0;
+    unsigned int month = 0, day = 0, hour = 0, minute = 0, second = 0, nanoSeconds = 0;
+    int8_t dst = INT8_INVALID;
+    stTimeZone zone = stTimeZone_Invalid;
+    unsigned int found = 0;
+    while (*format)
+    {
+        if (*format != '%')
+        {
+            if (source >= end || *source != *format) return 0;
+            source++;
+            format++;
+            continue;
+        }
+        format++;
+        if (*format >= '1' && *format <= '9') format++;
+        char symbol = *format++;
+        unsigned int value = 0;
+        const char* next = source;
+        switch (symbol)
+        {
+        case 'Y': case 'y': case 'm': case 'd': case 'e': case 'H': case 'M': case 'S':
+            next = scanNumber(source, end, symbol == 'Y' ? LibCpp_SCANYEARDIGITS : LibCpp_SCANDIGITS, &value);
+            if (!next) return 0;
+            if (next < end && symbol != 'S' && (*next == ',' || *next == 'e' || *next == 'E' || (*next == '.' && symbol != 'm' && symbol != 'd' && symbol != 'e')))
+                return 0;   // taken as float by LibOb_strptime
+            break;
+        default:
+            break;
+        }
+        switch (symbol)
+        {
+        case 'Y':
+            year = (int32_t)value;
+            found |= 0x01;
+            break;
+        case 'y':
+            year = (int32_t)value + ((value + 2000 > 2068) ? 1900 : 2000);
+            found |= 0x01;
+            break;
+        case 'm':
+            if (value < 1 || value > 12) return 0;
+            month = value;
+            found |= 0x02;
+            break;
+        case 'd':
+        case 'e':
+            if (value < 1) return 0;
+            day = value;
+            found |= 0x04;
+            break;
+        case 'H':
+            if (value > 23) return 0;
+            hour = value;
+            found |= 0x08;
+            break;
+        case 'M':
+            if (value > 59) return 0;
+            minute = value;
+            found |= 0x10;
+            break;
+        case 'S':
+            if (value > 59) return 0;
+            second = value;
+            found |= 0x20;
+            break;
+        case 'f':
+        {
+            unsigned int scale = LibCpp_NANOSECONDSPERSECOND;
+            nanoSeconds = 0;
+            while (next < end && (unsigned char)(*next - '0') <= 9)
+            {
+                if (scale > 1)
+                {
+                    scale /= 10;
+                    nanoSeconds += (unsigned int)(*next - '0') * scale;
+                }
+                next++;
+            }
+            if (next == source) return 0;
+            break;
+        }
+        case 'U':
+            if (end - source < 3) return 0;
+            if (memcmp(source, "UTC", 3) == 0) dst = -1;
+            else if (memcmp(source, "STD", 3) == 0) dst = 0;
+            else if (memcmp(source, "DST", 3) == 0) dst = 1;
+            else return 0;
+            next = source + 3;
+            break;
+        case 'z':
+        {
+            if (source >= end || (*source != '+' && *source != '-')) return 0;
+            bool negative = (*source == '-');
+            const char* digits = source + 1;
+            next = scanNumber(digits, end, 4, &value);
+            if (!next) return 0;
+            unsigned int hours = value;
+            unsigned int minutes = 0;
+            if (next - digits == 4)
+            {
+                hours = value / 100;
+                minutes = value % 100;
+            }
+            else if (next - digits <= 2 && next < end && *next == ':')
+            {
+                const char* minuteDigits = next + 1;
+                next = scanNumber(minuteDigits, end, 2, &minutes);
+                if (!next || next - minuteDigits != 2) return 0;
+            }
+            else
+                return 0;
+            if (hours > 14 || minutes > 59) return 0;
+            zone.hours = (int8_t)(negative ? -(int)hours : (int)hours);
+            zone.minutes = (uint8_t)minutes;
+            break;
+        }
+        default:
+            return 0;   // names, 12 hour clock and '%%' are left to LibOb_strptime
+        }
+        source = next;
+    }
+    if (found != LibCpp_SCANCOMPLETE) return 0;
+    int leap = LibOb_isLeapYear(year);
+    if (day > (unsigned int)(calendarMath::DAYSTILLMONTH[leap][month] - calendarMath::DAYSTILLMONTH[leap][month - 1]))
+        return 0;
+
+    int64_t wallClock = calendarMath::daysFromCivil(year, month, day) * LibCpp_SECONDSPERDAY
+                      + hour * LibCpp_SECONDSPERHOUR + minute * LibCpp_SECONDSPERMINUTE + second;
+    if (zone.hours != INT8_INVALID)
+        *pUnixTime = (time_t)(wallClock - calendarMath::zoneOffset(zone, dst));
+    else
+        *pUnixTime = localToUnix(wallClock, dst);
+    if (pNanoSeconds) *pNanoSeconds = nanoSeconds;
+    return source;
+}
+
+/** @} */
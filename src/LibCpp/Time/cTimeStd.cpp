@@ -96,10 +96,15 @@
  *
  * This code provides the class 'cTime' within the namespace 'LibCpp'. This class simplifies the
  * usage of date and time compared to the functions defined in 'time.h' and is based on those
- * functions, only.
+ * functions, only.\n
+ * Conversions within a given (fixed) time zone are calculated arithmetically (see cTime::unixToCalendar
+ * and cTime::calendarToUnix) without calling 'localtime' or 'mktime'. The system clock settings are only
+ * consulted for the local time zone and its daylight saving time.
  *
- * Each cTime instance stores the time as unix time, which are the seconds after 1.1.1970 00:00:00.
- * This integer value is the only member variable of the object.\n
+ * Each cTime instance stores the time as unix time, which are the seconds after 1.1.1970 00:00:00,
+ * together with the nano seconds after that second. These integer values are the only member variables
+ * of the object. The nano seconds are passed to the calendar data (stCalendar::nanoSeconds) and
+ * printed or parsed by the format symbol '%f' (see LibOb_strftime).\n
  * Basically you have access to the value itself or to a calendar representation. The term 'calendar'
  * within this documentation always means calendar and time information in the human understandable form of
  * year, hour, minute and so on.
@@ -139,9 +144,10 @@
  *     printf("Calendar  is: %s\n", cTime::toString(cal).c_str());
  *     // Calendar  is: 2023-09-20#17:17:38#UTC#+02:00
  * \endcode
- * It is also possible to "translate" date and time to another UTC relative time. (It is not possible
- * to translate to other geographic time zones as this would require dst-infomation to correctly
- * show the time. This is due to dst-information not being dependent on time zones but on specific countries.)
+ * It is also possible to "translate" date and time to another UTC relative time. (Translating to other
+ * geographic time zones requires dst-infomation to correctly show the time. This is due to dst-information
+ * not being dependent on time zones but on specific countries. It is read from the time zone data base
+ * by cZoneInfo, see cTime::calendar(const cZoneInfo&).)
  * For example to UTC calendar.
  * \code
  *     cal = timeNow.calendar(cTime::UTC);
@@ -182,7 +188,7 @@
  *     printf("Wait time is      : %s\n", timeWait.toDurationString().c_str());
  *     // local time zone is: +01:00
  *     // UTC deviation is  : +02:00
- *     // Calendar is       : 2023-09-20#20:17:38#DST#+01:00
+ *     // Calendar is       : 2023-09-20#17:17:38#DST#+01:00
  *     // Weekday is        : Wednesday
  *     // Wait time is      : D95#00:42:22
  * \endcode
@@ -196,9 +202,14 @@
 //#endif
 
 #include "cTime.h"
+#include "cCalendarMath.h"
+#include "cCalendarView.h"
+#include "cTimeFormat.h"
 
-#define LibCpp_SECONDSPERHOUR 3600  ///< Konstante
-#define LibCpp_SECONDSPERMINUTE 60  ///< Konstante
+// The calendar arithmetic is evaluated at compile time (see cCalendarMath.h)
+static_assert(LibCpp::calendarMath::daysFromCivil(2001, 1, 1) == LibCpp_DAYS1970TO2001, "400 year blocks start with 1.1.2001");
+static_assert(LibCpp::calendarMath::unixTime(2038, 1, 19, 3, 14, 8) == 0x80000000ll, "first unix time exceeding 32 bit");
+static_assert(LibCpp::calendarMath::unixToCalendar(-1).dayInWeek == 3, "31.12.1969 was a wednesday");
 
 //! @cond Doxygen_Suppress
 #define __STDC_LIB_EXT1__
@@ -206,6 +217,9 @@
 //! @endcond
 
 #include <cstring>
+#include <cstdlib>
+#include <atomic>
+#include <sys/stat.h>
 
 using namespace LibCpp;
 using namespace std;
@@ -217,22 +231,317 @@ const stCalendar LibCpp::stCalendar_IniUnix = {1970, 1, 1, 0, 0, 0, 0, {0, 0}, 0
 const stCalendar LibCpp::stCalendar_Invalid = {INT32_INVALID, UINT8_INVALID, UINT8_INVALID, UINT8_INVALID, UINT8_INVALID, UINT8_INVALID, INT8_INVALID, {INT8_INVALID, 0}, 0, UINT16_INVALID, UINT8_INVALID, UINT8_INVALID, UINT8_INVALID, INT8_INVALID, INT16_INVALID}; ///< stCalendar_Invalid
 const stDuration LibCpp::stDuration_Ini = {0, 0, 0, 0, 1};          ///< Initializer for stDuration
 
+/**
+ * Process wide context of the local time zone.
+ * Bits 0-7 zone hours, bits 8-15 zone minutes, bit 16 valid flag, bits 32-63 generation.
+ * The generation is incremented on each invalidation, thus a computation started before
+ * an invalidation cannot overwrite the invalidation.
+ */
+static std::atomic<uint64_t> zoneContext(0);
+static std::atomic<uint64_t> zoneContextCount(0);       ///< Number of computations of zoneContext
+static std::atomic<uint64_t> zoneFingerprint(0);        ///< Fingerprint of TZ and /etc/localtime, see checkZoneContext()
+
+#define LibCpp_ZONECONTEXT_VALID      ((uint64_t)1 << 16)   ///< Valid flag of zoneContext
+#define LibCpp_ZONECONTEXT_GENERATION ((uint64_t)1 << 32)   ///< Generation increment of zoneContext
+
+/**
+ * @brief Fingerprint of the local time zone configuration (TZ environment variable and /etc/localtime).
+ * @return FNV-1a hash
+ */
+static uint64_t localZoneFingerprint()
+{
+    uint64_t hash = 14695981039346656037ull;
+    const char* tz = getenv("TZ");
+    if (tz)
+        for (; *tz; tz++) hash = (hash ^ (uint8_t)*tz) * 1099511628211ull;
+    struct stat info;
+    if (stat("/etc/localtime", &info) == 0)
+    {
+        hash = (hash ^ (uint64_t)info.st_mtime) * 1099511628211ull;
+        hash = (hash ^ (uint64_t)info.st_ino) * 1099511628211ull;
+        hash = (hash ^ (uint64_t)info.st_size) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief Computes the local time zone from the system clock settings and stores it to zoneContext.
+ * The first computation also seeds zoneFingerprint, thus checkZoneContext() only reports later changes.
+ * @param context Value of zoneContext being read before.
+ * @return The new context value
+ */
+static uint64_t computeZoneContext(uint64_t context)
+{
+    uint64_t unseeded = 0;
+    zoneFingerprint.compare_exchange_strong(unseeded, localZoneFingerprint(), std::memory_order_relaxed);
+    stTimeZone zone = LibOb_localTimeZone(nullptr);
+    uint64_t computed = (context & ~(LibCpp_ZONECONTEXT_GENERATION - 1)) | LibCpp_ZONECONTEXT_VALID
+                      | ((uint64_t)zone.minutes << 8) | (uint8_t)zone.hours;
+    zoneContextCount.fetch_add(1, std::memory_order_relaxed);
+    zoneContext.compare_exchange_strong(context, computed, std::memory_order_release, std::memory_order_relaxed);
+    return computed;
+}
+
+#define LibCpp_DSTCACHESIZE    256                         ///< Slots of dstCache (power of 2), 1900 till 2155 without collision
+#define LibCpp_DSTCACHEMASK    (((uint64_t)1 << 25) - 1)   ///< Mask of a transition of a dstCache entry, also used as 'no transition'
+#define LibCpp_DSTCACHE_VALID  ((uint64_t)1 << 50)         ///< The dstCache entry holds the transitions of the year
+#define LibCpp_DSTCACHE_LIBC   ((uint64_t)2 << 50)         ///< The year has more than two transitions or offsets other than the cached zone and dst, localtime is used
+#define LibCpp_DSTCACHE_BUSY   UINT64_MAX                  ///< Key of a dstCache slot being written
+#define LibCpp_DSTCACHESAMPLE  (7 * LibCpp_SECONDSPERDAY)  ///< Sampling distance of the transition search
+
+/**
+ * @brief Slot of dstCache.
+ * The entry holds bits 0-24 end and bits 25-49 begin of the dst in seconds after the begin of the (UTC) year
+ * and bits 50-51 state. The key holds the full year (bits 0-31) and the full generation of zoneContext
+ * (bits 32-63) the entry belongs to.
+ */
+typedef struct _stDstCacheSlot
+{
+    std::atomic<uint64_t> key;      ///< Generation and year of the entry, LibCpp_DSTCACHE_BUSY while the entry is written
+    std::atomic<uint64_t> entry;    ///< Transitions and state
+} stDstCacheSlot;
+
+/**
+ * Process wide cache of the local dst transitions, one slot per year at index year modulo LibCpp_DSTCACHESIZE.
+ * The slots are shared by all threads without lock: a slot is written by one thread at a time (the one switching
+ * the key to LibCpp_DSTCACHE_BUSY), readers take the entry only if the key matches before and after reading it.
+ * An invalidation of the zone context changes the generation and with it all keys.
+ * A valid entry implies the UTC offset of the cached zone context (plus one hour during the dst) for the whole
+ * year. Years with other offsets (e.g. a changed standard offset, local mean time or a dst shift other than
+ * one hour) are marked LibCpp_DSTCACHE_LIBC.
+ */
+static stDstCacheSlot dstCache[LibCpp_DSTCACHESIZE];
+
+/**
+ * @brief Returns a valid zoneContext, computes it if required.
+ * @return Context value, see zoneContext
+ */
+static uint64_t validZoneContext()
+{
+    uint64_t context = zoneContext.load(std::memory_order_acquire);
+    if (!(context & LibCpp_ZONECONTEXT_VALID))
+        context = computeZoneContext(context);
+    return context;
+}
+
+/**
+ * @brief Geographic time zone held by a zoneContext value.
+ * @param context
+ * @return zone
+ */
+static stTimeZone contextZone(uint64_t context)
+{
+    stTimeZone zone;
+    zone.hours   = (int8_t)(context & 0xFF);
+    zone.minutes = (uint8_t)((context >> 8) & 0xFF);
+    return zone;
+}
+
+/**
+ * @brief Daylight saving time of the local clock according to localtime.
+ * @param unixTime
+ * @return 1 = dst, 0 = standard time
+ */
+static int8_t libcDst(time_t unixTime)
+{
+    struct tm lt = tm_Ini;
+    localtime_s(&lt, &unixTime);
+    return lt.tm_isdst > 0 ? 1 : 0;
+}
+
+/**
+ * @brief UTC offset of the local clock according to localtime.
+ * The offset is derived from the fields of the broken down time, thus tm_gmtoff is not required.
+ * @param unixTime
+ * @param pDst [output] 1 = dst, 0 = standard time
+ * @return Seconds to add to UTC to receive the wall clock time
+ */
+static int32_t libcOffset(time_t unixTime, int8_t* pDst)
+{
+    struct tm lt = tm_Ini;
+    *pDst = 0;
+    if (localtime_s(&lt, &unixTime) != 0) return 0;
+    *pDst = lt.tm_isdst > 0 ? 1 : 0;
+    int64_t wallClock = calendarMath::daysFromCivil(lt.tm_year + 1900, lt.tm_mon + 1, lt.tm_mday) * LibCpp_SECONDSPERDAY
+                      + lt.tm_hour * LibCpp_SECONDSPERHOUR + lt.tm_min * LibCpp_SECONDSPERMINUTE + lt.tm_sec;
+    return (int32_t)(wallClock - (int64_t)unixTime);
+}
+
+/**
+ * @brief Searches the local dst transitions of a year.
+ * The dst is sampled weekly by localtime, each change is located to the second by bisection. Periods
+ * shorter than the sampling distance are not detected. Each sample is checked against the offset the
+ * cache implies, the year is marked LibCpp_DSTCACHE_LIBC if they differ.
+ * @param yearStart Unix time of the begin of the year
+ * @param yearEnd Unix time of the begin of the next year
+ * @param standardOffset UTC offset of the standard time of the zone context
+ * @return Transitions and state of a dstCache entry
+ */
+static uint64_t computeDstTransitions(int64_t yearStart, int64_t yearEnd, int32_t standardOffset)
+{
+    int8_t state = 0;
+    if (libcOffset((time_t)yearStart, &state) != standardOffset + state * LibCpp_SECONDSPERHOUR)
+        return LibCpp_DSTCACHE_LIBC;
+    uint64_t begin = state ? 0 : LibCpp_DSTCACHEMASK;   // begin > end within the year: dst at the begin of the year
+    uint64_t end = state ? LibCpp_DSTCACHEMASK : 0;
+    int changes = 0;
+    int64_t previous = yearStart;
+    while (previous < yearEnd - 1)
+    {
+        int64_t sample = previous + LibCpp_DSTCACHESAMPLE;
+        if (sample > yearEnd - 1) sample = yearEnd - 1;
+        int8_t next = 0;
+        if (libcOffset((time_t)sample, &next) != standardOffset + next * LibCpp_SECONDSPERHOUR)
+            return LibCpp_DSTCACHE_LIBC;
+        if (next != state)
+        {
+            int64_t low = previous;     // state at low, next at high
+            int64_t high = sample;
+            while (high - low > 1)
+            {
+                int64_t middle = low + (high - low) / 2;
+                if (libcDst((time_t)middle) == state) low = middle;
+                else high = middle;
+            }
+            if (++changes > 2) return LibCpp_DSTCACHE_LIBC;
+            if (next) begin = (uint64_t)(high - yearStart);
+            else end = (uint64_t)(high - yearStart);
+            state = next;
+        }
+        previous = sample;
+    }
+    return LibCpp_DSTCACHE_VALID | (begin << 25) | end;
+}
+
+/**
+ * @brief UTC offset and daylight saving time of the local clock using the per year transition cache.
+ * The first access of a year searches its transitions (see computeDstTransitions), later accesses
+ * are two comparisons. Years marked LibCpp_DSTCACHE_LIBC are served by localtime.
+ * @param unixTime
+ * @param pDst [output] 1 = dst, 0 = standard time
+ * @return Seconds to add to UTC to receive the wall clock time
+ */
+static int32_t localOffset(time_t unixTime, int8_t* pDst)
+{
+    uint64_t context = validZoneContext();
+    int32_t standardOffset = calendarMath::zoneOffset(contextZone(context), 0);
+    uint64_t generation = context >> 32;
+    int64_t days = calendarMath::floorDivision((int64_t)unixTime, LibCpp_SECONDSPERDAY);
+    int32_t year = 0;
+    uint8_t month = 0;
+    uint8_t day = 0;
+    uint16_t dayInYear = 0;
+    calendarMath::civilFromDays(days, &year, &month, &day, &dayInYear);
+    int64_t yearStart = (days - dayInYear + 1) * LibCpp_SECONDSPERDAY;
+
+    uint64_t key = (generation << 32) | (uint32_t)year;
+    stDstCacheSlot& slot = dstCache[year & (LibCpp_DSTCACHESIZE - 1)];
+    uint64_t observed = slot.key.load(std::memory_order_acquire);
+    uint64_t entry = slot.entry.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (observed != key || slot.key.load(std::memory_order_relaxed) != key
+        || !(entry & (LibCpp_DSTCACHE_VALID | LibCpp_DSTCACHE_LIBC)))
+    {
+        int64_t yearLength = calendarMath::DAYSTILLMONTH[LibOb_isLeapYear(year)][12] * (int64_t)LibCpp_SECONDSPERDAY;
+        entry = computeDstTransitions(yearStart, yearStart + yearLength, standardOffset);
+        if (observed != LibCpp_DSTCACHE_BUSY
+            && slot.key.compare_exchange_strong(observed, LibCpp_DSTCACHE_BUSY, std::memory_order_relaxed))
+        {   // otherwise another thread writes the slot, the entry is used uncached
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.entry.store(entry, std::memory_order_relaxed);
+            slot.key.store(key, std::memory_order_release);
+        }
+    }
+    if (entry & LibCpp_DSTCACHE_LIBC) return libcOffset(unixTime, pDst);
+
+    uint64_t offset = (uint64_t)((int64_t)unixTime - yearStart);
+    uint64_t begin = (entry >> 25) & LibCpp_DSTCACHEMASK;
+    uint64_t end = entry & LibCpp_DSTCACHEMASK;
+    if (begin < end) *pDst = (offset >= begin && offset < end) ? 1 : 0;
+    else *pDst = (offset >= begin || offset < end) ? 1 : 0;
+    return standardOffset + *pDst * LibCpp_SECONDSPERHOUR;
+}
+
+/**
+ * @brief Daylight saving time of the local clock using the per year transition cache, see localOffset().
+ * @param unixTime
+ * @return 1 = dst, 0 = standard time
+ */
+static int8_t localDst(time_t unixTime)
+{
+    int8_t dst = 0;
+    localOffset(unixTime, &dst);
+    return dst;
+}
+
+/**
+ * @brief Unix time of a wall clock time of the local zone.
+ * Inverse of calendar(): the instants of the wall clock time at the standard offset of the zone context and
+ * one hour before are checked against the UTC offset valid at each of them (see localOffset), the first matching
+ * one is returned. Thus a wall clock time within the hour repeated at the end of the dst is taken as the earlier
+ * instant (dst), mktime itself is not consistent within the repeated hour. mktime is only called if neither
+ * instant matches, i.e. for a wall clock time skipped at the begin of the dst or a standard offset other than
+ * today's one plus one hour at most.
+ * @param wallClock Seconds since 1.1.1970 of the wall clock time
+ * @param dst 1 = DST, 0 = STD, any other value for the dst valid at that time
+ * @return unix time
+ */
+time_t cTime::localToUnix(int64_t wallClock, int8_t dst)
+{
+    bool anyDst = dst != 0 && dst != 1;
+    time_t standard = (time_t)(wallClock - calendarMath::zoneOffset(localTimeZone(), 0));
+    time_t candidates[2] = {standard - LibCpp_SECONDSPERHOUR, standard};    // dst first
+    for (time_t candidate : candidates)
+    {
+        int8_t candidateDst = 0;
+        int32_t offset = localOffset(candidate, &candidateDst);
+        if ((int64_t)candidate + offset == wallClock && (anyDst || candidateDst == dst))
+            return candidate;
+    }
+
+    int64_t second = 0;
+    int64_t days = calendarMath::floorDivision(wallClock, LibCpp_SECONDSPERDAY, &second);
+    int32_t year = 0;
+    uint8_t month = 0;
+    uint8_t day = 0;
+    calendarMath::civilFromDays(days, &year, &month, &day);
+    struct tm tmCalendar = tm_Ini;
+    tmCalendar.tm_year  = year - 1900;
+    tmCalendar.tm_mon   = month - 1;
+    tmCalendar.tm_mday  = day;
+    tmCalendar.tm_hour  = (int)(second / LibCpp_SECONDSPERHOUR);
+    tmCalendar.tm_min   = (int)(second % LibCpp_SECONDSPERHOUR / LibCpp_SECONDSPERMINUTE);
+    tmCalendar.tm_sec   = (int)(second % LibCpp_SECONDSPERMINUTE);
+    tmCalendar.tm_isdst = anyDst ? -1 : dst;
+    return mktime(&tmCalendar);
+}
+
 /**
  * @brief Constructor
  */
 cTime::cTime()
 {
     _time = 0;
+    _nanoSeconds = 0;
 }
 
 /**
  * @brief Deliveres a cTime instance holding the current time.
+ * The time is read with nano second resolution. On POSIX systems clock_gettime(CLOCK_REALTIME)
+ * is served by the vDSO without a system call.
  * @return Created instance
  */
 cTime cTime::now()
 {
     cTime result;
-    result._time = ::time(nullptr);
+    struct timespec now;
+#ifdef _WIN32
+    timespec_get(&now, TIME_UTC);
+#else
+    clock_gettime(CLOCK_REALTIME, &now);
+#endif
+    result._time = now.tv_sec;
+    result._nanoSeconds = (uint32_t)now.tv_nsec;
     return result;
 }
 
@@ -248,6 +557,22 @@ cTime cTime::set(time_t unixTime)
     return t;
 }
 
+/**
+ * @brief Deliveres a cTime instance initialized with unixTime and nano seconds after it.
+ * Nano seconds outside 0-999999999 are carried into the seconds, thus a negative value
+ * lies before unixTime.
+ * @param unixTime
+ * @param nanoSeconds
+ * @return Created instance
+ */
+cTime cTime::set(time_t unixTime, int64_t nanoSeconds)
+{
+    cTime t;
+    t._time = unixTime + (time_t)calendarMath::floorDivision(nanoSeconds, LibCpp_NANOSECONDSPERSECOND);
+    t._nanoSeconds = (uint32_t)calendarMath::floorModulo(nanoSeconds, LibCpp_NANOSECONDSPERSECOND);
+    return t;
+}
+
 /**
  * @brief Deliveres a cTime instance initialized with the calendar data input.
  * The calendar data is to be provided as /ref stCalendar struct.
@@ -256,6 +581,11 @@ cTime cTime::set(time_t unixTime)
  */
 cTime cTime::set(stCalendar calendar)
 {
+    int64_t nanoSeconds = (calendar.nanoSeconds < LibCpp_NANOSECONDSPERSECOND) ? calendar.nanoSeconds : 0;
+    if (calendar.timeZone.hours != INT8_INVALID)
+        return set(calendarToUnix(calendar), nanoSeconds);
+
+    // No time zone given, the calendar is interpreted as local wall clock time
     struct tm tmCalendar = tm_Ini;
     tmCalendar.tm_year  = calendar.year - 1900;
     tmCalendar.tm_mon   = calendar.month - 1;
@@ -263,13 +593,10 @@ cTime cTime::set(stCalendar calendar)
     tmCalendar.tm_hour  = calendar.hour;
     tmCalendar.tm_min   = calendar.minute;
     tmCalendar.tm_sec   = calendar.second;
-    tmCalendar.tm_isdst = calendar.dst;
-    time_t timeValue = mktime(&tmCalendar);
-    stTimeZone localZone = localTimeZone();
-    int dst = 0;
-    if (tmCalendar.tm_isdst) dst=1;
-    timeValue += (localZone.hours + dst + calendar.timeZone.hours) * LibCpp_SECONDSPERHOUR + calendar.timeZone.minutes * LibCpp_SECONDSPERMINUTE;
-    return set(timeValue);
+    tmCalendar.tm_isdst = -1;
+    if (calendar.dst != INT8_INVALID)
+        tmCalendar.tm_isdst = calendar.dst;
+    return set(mktime(&tmCalendar), nanoSeconds);
 }
 
 /**
@@ -323,19 +650,29 @@ cTime cTime::set(uint64_t days, uint64_t hours, uint64_t minutes, uint64_t secon
 
 /**
  * @brief Deliveres a cTime instance initialized by a string representing either a calendar or a duration string.
+ * The string is not copied and needs not to be zero terminated. Thus a time stamp can be read directly out
+ * of a larger buffer, e.g. cTime::set(std::string_view(pLine, 30)).\n
+ * Numeric calendar strings are converted in a single pass (see cTime::scan), other strings by fromString().
  * @param dateString
  * @param format
  * @return Created instance
  */
-cTime cTime::set(std::string dateString, std::string format)
+cTime cTime::set(std::string_view dateString, const std::string& format)
 {
-  if (dateString[0] == 'D')
+  if (!dateString.empty() && dateString[0] == 'D')
   {
-      stDuration duration = fromDurationString(dateString);
+      stDuration duration = fromDurationString(std::string(dateString));
       return set(duration);
   }
   else
   {
+      time_t unixTime = 0;
+      uint32_t nanoSeconds = 0;
+      if ((format == "" || format == LibOb_DEFAULTFORMAT) && dateString.size() == 30 && scanGZC(dateString.data(), &unixTime))
+          return set(unixTime);
+      const char* end = scan(dateString.data(), dateString.size(), format.c_str(), &unixTime, &nanoSeconds);
+      if (end && end == dateString.data() + dateString.size())
+          return set(unixTime, (int64_t)nanoSeconds);
       stCalendar calendar = fromString(dateString, format);
       return set(calendar);
   }
@@ -345,64 +682,187 @@ cTime cTime::set(std::string dateString, std::string format)
  * @brief Returns the unix time stamp (seconds till 1.1.1970 00:00:00 GMT).
  * @return unix time
  */
-time_t cTime::time()
+time_t cTime::time() const
 {
     return _time;
 }
 
+/**
+ * @brief Returns the nano seconds after the unix time stamp.
+ * @return nano seconds 0-999999999
+ */
+uint32_t cTime::nanoSeconds() const
+{
+    return _nanoSeconds;
+}
+
+/**
+ * @brief Zone, dst and UTC offset of the calendar data representation of the instance, see calendar().
+ * The offset of the local zone is resolved for the instance (see localOffset), the zone is the cached local
+ * zone as long as it matches that offset. Instants whose standard offset differs from the one of today
+ * (e.g. Europe/Moscow 2011-2014 or local mean time) are labelled with the zone derived from their own offset,
+ * see calendarMath::offsetToCalendar(), or with a UTC relative zone if the offset and dst cannot be expressed
+ * as geographic zone. The label has minute resolution (see calendarMath::offsetZone).
+ * @param pRequestedTimeZone Pointer to a variable containing the desired UTC time deviation.
+ * @param pZone [output] Geographic or UTC relative time zone
+ * @param pDst [output] dst, -1 for a UTC relative time zone
+ * @param pUtcOffset [output] Seconds to add to UTC to receive the wall clock time
+ */
+void cTime::requestedZone(int8_t* pRequestedTimeZone, stTimeZone* pZone, int8_t* pDst, int32_t* pUtcOffset)
+{
+    if (pRequestedTimeZone && *pRequestedTimeZone != INT8_INVALID)
+    {   // fixed UTC relative zone, no system clock settings involved
+        *pZone = stTimeZone_Ini;
+        pZone->hours = *pRequestedTimeZone;
+        *pDst = -1;
+        *pUtcOffset = calendarMath::zoneOffset(*pZone, -1);
+        return;
+    }
+
+    int8_t dst = 0;
+    int32_t offset = localOffset(_time, &dst);  // cached per year, see computeDstTransitions()
+    *pUtcOffset = offset;
+    if (pRequestedTimeZone)
+    {
+        *pZone = calendarMath::offsetZone(offset);
+        *pDst = -1;
+        return;
+    }
+    stTimeZone zone = localTimeZone();
+    if (offset != calendarMath::zoneOffset(zone, dst))
+    {   // standard offset other than today's
+        zone = calendarMath::offsetZone(offset - dst * LibCpp_SECONDSPERHOUR);
+        if (dst > 0 && calendarMath::zoneOffset(zone, 0) / LibCpp_SECONDSPERMINUTE != (offset - LibCpp_SECONDSPERHOUR) / LibCpp_SECONDSPERMINUTE)
+        {   // standard time not representable as geographic zone (e.g. a dst shift of 20 minutes)
+            zone = calendarMath::offsetZone(offset);
+            dst = -1;
+        }
+    }
+    *pZone = zone;
+    *pDst = dst;
+}
+
 /**
  * @brief Returns the calendar data representation of the instance.
  * Returns the memorized unix time as calendar data based on the local system clock configuration.
+ * The UTC offset and daylight saving time are taken from a process wide per year cache of the local dst
+ * transitions, thus localtime is called once per year (see cTime::invalidateZoneContext). Years whose
+ * offsets differ from the standard offset of today plus the dst hour are served by localtime.
+ * The wall clock time is exact for any offset, the zone of the calendar has minute resolution
+ * (see calendarMath::offsetZone).
  * In case 'pRequestedTimeZone' is set and points to a int8_t variable containing the requested
  * UTC time deviation, the corresponding date and time is returned.\n
  * Use 'cTime::UTC' as parameter to receive the calendar data valid at UTC deviation zero.\n
  * Use 'cTime::asUTC' to keep the local date and time string but using UTC time deviation
- * instead of geographic time zone. This is useful for creating ISO8601 conform strings.
+ * instead of geographic time zone. This is useful for creating ISO8601 conform strings.\n
+ * Callers needing single entries use view() or the accessors year(), hour() and so on.
  * @param pRequestedTimeZone Pointer to a variable containing the desired UTC time deviation.
  * @return calendar struct
  */
 stCalendar cTime::calendar(int8_t* pRequestedTimeZone)
 {
-    struct tm lt = tm_Ini;
-    int8_t zone = localTimeZone().hours;
-    localtime_s(&lt, &_time);
+    stTimeZone zone;
+    int8_t dst;
+    int32_t offset;
+    requestedZone(pRequestedTimeZone, &zone, &dst, &offset);
+    stCalendar result = unixToCalendar(_time, offset, zone, dst);
+    result.nanoSeconds = _nanoSeconds;
+    return result;
+}
 
-    stCalendar calendar = stCalendar_Ini;
+/**
+ * @brief Returns a calendar view of the instance calculating each entry when asked for.
+ * The zone is resolved as by calendar(), see cCalendarView.h.
+ * @param pRequestedTimeZone Pointer to a variable containing the desired UTC time deviation.
+ * @return calendar view
+ */
+cCalendarView cTime::view(int8_t* pRequestedTimeZone)
+{
+    stTimeZone zone;
+    int8_t dst;
+    int32_t offset;
+    requestedZone(pRequestedTimeZone, &zone, &dst, &offset);
+    return cCalendarView(_time, offset, zone, dst, _nanoSeconds);
+}
 
-    if (pRequestedTimeZone)
-    {
-        int8_t relZone = zone;
-        if (lt.tm_isdst>0)
-            relZone += 1;
+/**
+ * @brief Returns the year of the calendar data representation, see calendar().
+ * @param pRequestedTimeZone Pointer to a variable containing the desired UTC time deviation.
+ * @return year
+ */
+int32_t cTime::year(int8_t* pRequestedTimeZone)
+{
+    return view(pRequestedTimeZone).year();
+}
 
-        int8_t relDestZone;
-        if (*pRequestedTimeZone == INT8_INVALID)
-        {
-            relDestZone = zone;
-            if (lt.tm_isdst > 0) relDestZone++;
-        }
-        else
-            relDestZone = *pRequestedTimeZone;
-        lt.tm_hour += relDestZone - relZone;
-        mktime(&lt);
-        lt.tm_isdst = -1;
-        calendar.timeZone.hours = relDestZone;
-    }
-    else
-        calendar.timeZone.hours = zone;
-
-    calendar.second    = lt.tm_sec;         // seconds after the minute	0-60*
-    calendar.minute    = lt.tm_min;         // minutes after the hour	0-59
-    calendar.hour      = lt.tm_hour;        // hours since midnight	0-23
-    calendar.day       = lt.tm_mday;        // day of the month	1-31
-    calendar.month     = lt.tm_mon	+ 1;    // months since January	0-11
-    calendar.year      = lt.tm_year	+ 1900; // years since 1900
-    calendar.dst       = lt.tm_isdst;       // Daylight Saving Time flag
-    calendar.dayInWeek = lt.tm_wday;
-    if (!calendar.dayInWeek) calendar.dayInWeek = 7;
-    calendar.dayInYear = lt.tm_yday + 1;
+/**
+ * @brief Returns the month of the calendar data representation, see calendar().
+ * @param pRequestedTimeZone Pointer to a variable containing the desired UTC time deviation.
+ * @return month 1-12
+ */
+uint8_t cTime::month(int8_t* pRequestedTimeZone)
+{
+    return view(pRequestedTimeZone).month();
+}
 
-    return calendar;
+/**
+ * @brief Returns the day of the calendar data representation, see calendar().
+ * @param pRequestedTimeZone Pointer to a variable containing the desired UTC time deviation.
+ * @return day 1-31
+ */
+uint8_t cTime::day(int8_t* pRequestedTimeZone)
+{
+    return view(pRequestedTimeZone).day();
+}
+
+/**
+ * @brief Returns the hour of the calendar data representation, see calendar(). The date is not calculated.
+ * @param pRequestedTimeZone Pointer to a variable containing the desired UTC time deviation.
+ * @return hour 0-23
+ */
+uint8_t cTime::hour(int8_t* pRequestedTimeZone)
+{
+    return view(pRequestedTimeZone).hour();
+}
+
+/**
+ * @brief Returns the minute of the calendar data representation, see calendar(). The date is not calculated.
+ * @param pRequestedTimeZone Pointer to a variable containing the desired UTC time deviation.
+ * @return minute 0-59
+ */
+uint8_t cTime::minute(int8_t* pRequestedTimeZone)
+{
+    return view(pRequestedTimeZone).minute();
+}
+
+/**
+ * @brief Returns the second of the calendar data representation, see calendar(). The date is not calculated.
+ * @param pRequestedTimeZone Pointer to a variable containing the desired UTC time deviation.
+ * @return second 0-59
+ */
+uint8_t cTime::second(int8_t* pRequestedTimeZone)
+{
+    return view(pRequestedTimeZone).second();
+}
+
+/**
+ * @brief Returns the day in the week of the calendar data representation, see calendar(). The date is not calculated.
+ * @param pRequestedTimeZone Pointer to a variable containing the desired UTC time deviation.
+ * @return 1-7 as 1 for monday
+ */
+uint8_t cTime::dayInWeek(int8_t* pRequestedTimeZone)
+{
+    return view(pRequestedTimeZone).dayInWeek();
+}
+
+/**
+ * @brief Returns the day in the year of the calendar data representation, see calendar().
+ * @param pRequestedTimeZone Pointer to a variable containing the desired UTC time deviation.
+ * @return 1-366 as 1 for the 1st of January
+ */
+uint16_t cTime::dayInYear(int8_t* pRequestedTimeZone)
+{
+    return view(pRequestedTimeZone).dayInYear();
 }
 
 /**
@@ -418,6 +878,7 @@ stDuration cTime::duration()
     {
         duration.sign = -1;
         value = -value;
+        if (_nanoSeconds) value--;  // the fraction of a second is truncated towards zero
     }
     duration.days = value / 86400;
     value = value % 86400;
@@ -474,7 +935,52 @@ stCalendar cTime::setCalendar(int32_t year, uint8_t month, uint8_t day, uint8_t
  */
 stTimeZone cTime::localTimeZone(int8_t* pDst)
 {
-    return LibOb_localTimeZone(pDst);
+    stTimeZone zone = contextZone(validZoneContext());
+    if (pDst)
+        *pDst = localDst(::time(nullptr));
+    return zone;
+}
+
+/**
+ * @brief Discards the cached local time zone.
+ * The local time zone is computed once and cached for the whole process (see localTimeZone).
+ * Call this method after changing the TZ environment variable or the system time zone. The
+ * next call of localTimeZone() computes the zone again, the cached dst transitions of all years
+ * are searched again on their next use.
+ */
+void cTime::invalidateZoneContext()
+{
+    tzset();
+    uint64_t context = zoneContext.load(std::memory_order_relaxed);
+    uint64_t invalid;
+    do
+        invalid = (context & ~(LibCpp_ZONECONTEXT_GENERATION - 1)) + LibCpp_ZONECONTEXT_GENERATION;
+    while (!zoneContext.compare_exchange_weak(context, invalid, std::memory_order_release, std::memory_order_relaxed));
+}
+
+/**
+ * @brief Invalidates the cached local time zone if the TZ environment variable or /etc/localtime changed.
+ * The check costs a getenv() and a stat() call. It is not done implicitly, call it periodically
+ * (e.g. once a minute) in long running processes whose time zone configuration may change.
+ * @return true if the configuration changed and the cached zone has been invalidated
+ */
+bool cTime::checkZoneContext()
+{
+    uint64_t fingerprint = localZoneFingerprint();
+    if (zoneFingerprint.exchange(fingerprint) == fingerprint)
+        return false;
+    invalidateZoneContext();
+    return true;
+}
+
+/**
+ * @brief Number of times the cached local time zone has been computed.
+ * Each invalidation leads to one (or in case of concurrent first access a few) computations.
+ * @return Number of computations
+ */
+uint64_t cTime::zoneContextRecomputations()
+{
+    return zoneContextCount.load(std::memory_order_relaxed);
 }
 
 /**
@@ -492,18 +998,23 @@ stTimeZone cTime::UTCdeviation(stTimeZone zone, int8_t dst)
 
 /**
  * @brief Delivers a calendar struct from a \ref GZC formatted string.
+ * The string is not copied and needs not to be zero terminated (see LibOb_strnptime).
  * @param dateString Input date string.
  * @param format Format string.
  * @return
  */
-stCalendar cTime::fromString(std::string dateString, std::string format)
+stCalendar cTime::fromString(std::string_view dateString, const std::string& format)
 {
     struct tm tmCal = tm_Invalid;
     stTimeZone zone = stTimeZone_Invalid;
 
-    if (dateString[0] == 'D') return stCalendar_Invalid;
-    LibOb_strptime(dateString.c_str(), format.c_str(), &tmCal, &zone);
-    return toCalendar(tmCal, &zone);
+    uint32_t nanoSeconds = 0;
+
+    if (dateString.empty() || dateString[0] == 'D') return stCalendar_Invalid;
+    LibOb_strnptimeNano(dateString.data(), dateString.size(), format.c_str(), &tmCal, &zone, &nanoSeconds);
+    stCalendar calendar = toCalendar(tmCal, &zone);
+    calendar.nanoSeconds = nanoSeconds;
+    return calendar;
 }
 
 /**
@@ -568,12 +1079,76 @@ std::string cTime::toDurationString()
 std::string cTime::toString(stCalendar calendar, std::string format, enLanguage* pLanguage)
 {
     char buffer[64];
-    stTimeZone zone;
-    struct tm t = cTime::fromCalendar(calendar, &zone);
-    if (format=="") format = "%Y-%m-%d#%H:%M:%S#%U#%z";
-    LibOb_strftime(buffer, 64, format.c_str(), &t, &zone, pLanguage);
-    string result(buffer);
-    return result;
+    size_t length = cTime::format(buffer, 64, calendar, format.c_str(), pLanguage);
+    return string(buffer, length);
+}
+
+/**
+ * @brief Writes the string interpretation of the 'calendar' method result to a buffer.
+ * Same result as toString() without the allocation of a std::string.
+ * @param destination String buffer
+ * @param destinationSize String buffer size
+ * @param format See \ref TIME_FORMATTING, an empty string is the default format.
+ * @param pLanguage
+ * @param pRequestedTimeZone See calendar().
+ * @return Number of characters written to destination (without termination)
+ */
+size_t cTime::format(char* destination, size_t destinationSize, const char* format, enLanguage* pLanguage, int8_t* pRequestedTimeZone)
+{
+    return cTime::format(destination, destinationSize, calendar(pRequestedTimeZone), format, pLanguage);
+}
+
+/**
+ * @brief Writes a \ref GZC formatted string of a calendar struct to a buffer.
+ * The format is walked once, the literal text is copied and the numbers are written directly
+ * from the calendar entries (timeFormat::formatSymbol). The struct tm is only built if a name
+ * ('%a', '%A', '%b', '%B', '%Z') is formatted. At an unknown symbol the whole format is passed to LibOb_strftimeNano().
+ * The result equals LibOb_strftimeNano() of fromCalendar(): the string is always terminated and
+ * in case a field does not fit, the conversion stops before that field.
+ * @param destination String buffer
+ * @param destinationSize String buffer size
+ * @param calendar
+ * @param format See \ref TIME_FORMATTING, an empty string is the default format.
+ * @param pLanguage
+ * @return Number of characters written to destination (without termination)
+ */
+size_t cTime::format(char* destination, size_t destinationSize, const stCalendar& calendar, const char* format, enLanguage* pLanguage)
+{
+    if (!destination || destinationSize == 0) return 0;
+    if (!format || *format == 0) format = LibOb_DEFAULTFORMAT;
+    const char* formatBegin = format;
+    char* position = destination;
+    const char* end = destination + destinationSize - 1;    // reserved for termination
+    char field[32];
+    while (*format && position < end)
+    {
+        if (*format != '%')
+        {
+            *position++ = *format++;
+            continue;
+        }
+        format++;
+        uint8_t modifier = 0;
+        if (*format >= '1' && *format <= '9') modifier = (uint8_t)(*format++ - '0');
+        char* target = (end - position >= (ptrdiff_t)sizeof(field)) ? position : field;
+        char* next = timeFormat::formatSymbol(target, *format, modifier, calendar, nullptr, nullptr, pLanguage);
+        if (!next)
+        {
+            stTimeZone zone = stTimeZone_Invalid;
+            struct tm t = cTime::fromCalendar(calendar, &zone);
+            return LibOb_strftimeNano(destination, destinationSize, formatBegin, &t, &zone, pLanguage, calendar.nanoSeconds);
+        }
+        format++;
+        size_t length = (size_t)(next - target);
+        if (target == field)
+        {
+            if (length > (size_t)(end - position)) break;
+            memcpy(position, field, length);
+        }
+        position += length;
+    }
+    *position = 0;
+    return (size_t)(position - destination);
 }
 
 /**
@@ -675,6 +1250,144 @@ stCalendar cTime::toCalendar(struct tm tmCalendar, const stTimeZone* pTimeZone)
     return calendar;
 }
 
+/**
+ * @brief Seconds to add to UTC to receive the wall clock time of the given zone and dst.
+ * The minutes of the zone carry the sign of the hours, e.g. {-3, 30} is the zone -03:30.
+ * See calendarMath::zoneOffset for compile time usage.
+ * @param zone Geographic time zone (dst = 0 or 1) or UTC relative time zone (dst = -1).
+ * @param dst
+ * @return Offset in seconds
+ */
+int32_t cTime::zoneOffset(stTimeZone zone, int8_t dst)
+{
+    return calendarMath::zoneOffset(zone, dst);
+}
+
+/**
+ * @brief Days since 1.1.1970 of a (proleptic gregorian) date.
+ * The date is split into 400, 100 and 4 year blocks beginning with the year 2001 (see y2038Calendar.cpp).
+ * Months outside 1-12 and days beyond the end of the month are carried over like mktime() does.
+ * No library functions are called. See calendarMath::daysFromCivil for compile time usage.
+ * @param year
+ * @param month 1-12
+ * @param day 1-31
+ * @return Days since 1.1.1970, negative for earlier dates
+ */
+int64_t cTime::daysFromCivil(int32_t year, uint8_t month, uint8_t day)
+{
+    return calendarMath::daysFromCivil(year, month, day);
+}
+
+/**
+ * @brief Date of the given days since 1.1.1970.
+ * Inverse of daysFromCivil(). No library functions are called. See calendarMath::civilFromDays for compile time usage.
+ * @param days Days since 1.1.1970
+ * @param pYear [output]
+ * @param pMonth [output] 1-12
+ * @param pDay [output] 1-31
+ * @param pDayInYear [output] 1-366, may be zero
+ */
+void cTime::civilFromDays(int64_t days, int32_t* pYear, uint8_t* pMonth, uint8_t* pDay, uint16_t* pDayInYear)
+{
+    calendarMath::civilFromDays(days, pYear, pMonth, pDay, pDayInYear);
+}
+
+/**
+ * Last converted day of each thread. Consecutive time stamps mostly fall on the same day,
+ * thus cTime::unixToCalendar() only derives hour, minute and second if the wall clock time
+ * lies within the day starting at dayStart. The distance to dayStart is taken in unsigned arithmetic,
+ * thus the initial INT64_MIN (no day, far below any calendar year) cannot overflow.
+ */
+typedef struct _stDayCache
+{
+    int64_t    dayStart;    ///< Wall clock seconds since 1.1.1970 of 00:00:00 of the day
+    stCalendar calendar;    ///< Date entries of the day
+} stDayCache;
+
+static thread_local stDayCache dayCache = {INT64_MIN, {}};   ///< Last converted day of the thread
+static thread_local uint64_t dayCacheHitCount = 0;          ///< Conversions of the thread hitting dayCache
+static thread_local uint64_t dayCacheMissCount = 0;         ///< Conversions of the thread missing dayCache
+
+/**
+ * @brief Calendar data of a unix time within a fixed zone.
+ * The zone and dst are not taken from the system clock settings but used as given, see \ref zoneOffset.
+ * No library functions (localtime, mktime) are called. See calendarMath::unixToCalendar for compile time usage.
+ * The date of the last converted day is memorized per thread, a time stamp of the same day only
+ * derives hour, minute and second (see dayCacheHits and dayCacheMisses).
+ * @param unixTime
+ * @param zone Geographic time zone (dst = 0 or 1) or UTC relative time zone (dst = -1).
+ * @param dst
+ * @return calendar struct
+ */
+stCalendar cTime::unixToCalendar(time_t unixTime, stTimeZone zone, int8_t dst)
+{
+    return unixToCalendar(unixTime, calendarMath::zoneOffset(zone, dst), zone, dst);
+}
+
+/**
+ * @brief Calendar data of a unix time at the given UTC offset, labelled with the given zone and dst.
+ * The date and time entries are computed from utcOffset only, see calendarMath::unixToCalendar.
+ * Shares the per thread memory of the last converted day with unixToCalendar(time_t, stTimeZone, int8_t).
+ * @param unixTime
+ * @param utcOffset Seconds to add to UTC to receive the wall clock time
+ * @param zone Zone stored to the calendar
+ * @param dst Dst stored to the calendar
+ * @return calendar struct
+ */
+stCalendar cTime::unixToCalendar(time_t unixTime, int32_t utcOffset, stTimeZone zone, int8_t dst)
+{
+    int64_t wallTime = (int64_t)unixTime + utcOffset;
+    uint64_t second = (uint64_t)wallTime - (uint64_t)dayCache.dayStart;
+    if (second < LibCpp_SECONDSPERDAY)
+    {   // same day as the last conversion of this thread, only the time of the day is derived
+        dayCacheHitCount++;
+        stCalendar calendar = dayCache.calendar;
+        calendar.hour      = (uint8_t)(second / LibCpp_SECONDSPERHOUR);
+        second            %= LibCpp_SECONDSPERHOUR;
+        calendar.minute    = (uint8_t)(second / LibCpp_SECONDSPERMINUTE);
+        calendar.second    = (uint8_t)(second % LibCpp_SECONDSPERMINUTE);
+        calendar.dst       = dst;
+        calendar.timeZone  = zone;
+        return calendar;
+    }
+
+    dayCacheMissCount++;
+    stCalendar calendar = calendarMath::unixToCalendar(unixTime, utcOffset, zone, dst);
+    dayCache.dayStart = wallTime - (int64_t)calendar.hour * LibCpp_SECONDSPERHOUR - calendar.minute * LibCpp_SECONDSPERMINUTE - calendar.second;
+    dayCache.calendar = calendar;
+    return calendar;
+}
+
+/**
+ * @brief Number of conversions of the calling thread taking the date from the last converted day (see unixToCalendar).
+ * @return Number of hits
+ */
+uint64_t cTime::dayCacheHits()
+{
+    return dayCacheHitCount;
+}
+
+/**
+ * @brief Number of conversions of the calling thread calculating the date (see unixToCalendar).
+ * @return Number of misses
+ */
+uint64_t cTime::dayCacheMisses()
+{
+    return dayCacheMissCount;
+}
+
+/**
+ * @brief Unix time of calendar data carrying a valid zone.
+ * Inverse of unixToCalendar(). Entries exceeding their range are carried over like mktime() does.
+ * No library functions are called. See calendarMath::calendarToUnix for compile time usage.
+ * @param calendar Calendar data, the time zone must be valid. An invalid dst is treated as UTC relative zone.
+ * @return unix time
+ */
+time_t cTime::calendarToUnix(stCalendar calendar)
+{
+    return calendarMath::calendarToUnix(calendar);
+}
+
 /**
  * @brief operator <<
  * @param out Output stream.
@@ -0,0 +1,339 @@
+// utf-8 (ü)
+
+// MIT License
+// Copyright © 2023 Olaf Simon
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+/**
+ * @file   cZoneInfo.cpp
+ * @author Olaf Simon
+ * @brief  Geographic time zones of the IANA time zone database of class LibCpp::cZoneInfo
+ *
+ * \addtogroup LibCpp_time
+ * @{
+ *
+ * Without a data base cTime converts to the local zone (system clock settings) and fixed UTC offsets only,
+ * as the dst rules are defined by countries and not by time zones. Most systems ship the IANA
+ * time zone data base as TZif files (RFC 8536), e.g. in /usr/share/zoneinfo. cZoneInfo reads
+ * such a file (version 1, 2 or 3) into a sorted array of transition times and a small table of local
+ * time types. A conversion is a binary search within the transitions.
+ *
+ * \code
+ * cZoneInfo newYork;
+ * if (newYork.load("America/New_York"))
+ * {
+ *     stCalendar cal = cTime::now().calendar(newYork);
+ *     printf("%s\n", cTime::toString(cal).c_str());    // 2023-09-20#11:17:38#DST#-05:00
+ * }
+ * \endcode
+ *
+ * The zone directory is taken from the environment variable TZDIR, /usr/share/zoneinfo otherwise.
+ * Leap second corrections ('right/' zones) are ignored. After the last transition the footer rule is
+ * evaluated (see cZoneRule), thus also files without transitions beyond the current year ('slim' files)
+ * convert correctly. Without footer the local time type of the last transition is used.
+ * Offsets are kept in seconds, the wall clock time of calendar() is exact also for offsets with seconds.
+ * Only the zone of the calendar has minute resolution (see calendarMath::offsetToCalendar()). Such offsets
+ * are not limited to the local mean time before about 1900, some zones kept them much longer
+ * (e.g. America/St_Johns until 1935, Asia/Kolkata until about 1942).
+**/
+
+#include "cZoneInfo.h"
+#include "cCalendarMath.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace LibCpp;
+
+#define LibCpp_ZONEINFODIRECTORY "/usr/share/zoneinfo"  ///< Default directory of the TZif files
+#define LibCpp_TZIFHEADERSIZE 44                        ///< Size of a TZif header
+
+static const stZoneType zoneTypeUTC = {0, 0, 0};        ///< Local time type used without a loaded zone
+
+/**
+ * @brief Counts of a TZif header.
+**/
+typedef struct _stTZifHeader
+{
+    char     version;       ///< 0, '2' or '3'
+    uint64_t isutcnt;       ///< Number of UT/local indicators
+    uint64_t isstdcnt;      ///< Number of standard/wall indicators
+    uint64_t leapcnt;       ///< Number of leap second records
+    uint64_t timecnt;       ///< Number of transitions
+    uint64_t typecnt;       ///< Number of local time types
+    uint64_t charcnt;       ///< Number of characters of the abbreviations
+} stTZifHeader;
+
+/**
+ * @brief Reads a big endian 32 bit value.
+ * @param p
+ * @return value
+ */
+static uint32_t readUint32(const uint8_t* p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/**
+ * @brief Reads a big endian 64 bit value.
+ * @param p
+ * @return value
+ */
+static int64_t readInt64(const uint8_t* p)
+{
+    return (int64_t)(((uint64_t)readUint32(p) << 32) | readUint32(p + 4));
+}
+
+/**
+ * @brief Reads a TZif header.
+ * @param data
+ * @param size Number of bytes available at 'data'.
+ * @param pHeader Resulting counts.
+ * @return false if the data is no TZif header.
+ */
+static bool readHeader(const uint8_t* data, size_t size, stTZifHeader* pHeader)
+{
+    if (size < LibCpp_TZIFHEADERSIZE || memcmp(data, "TZif", 4) != 0) return false;
+    pHeader->version  = (char)data[4];
+    pHeader->isutcnt  = readUint32(data + 20);
+    pHeader->isstdcnt = readUint32(data + 24);
+    pHeader->leapcnt  = readUint32(data + 28);
+    pHeader->timecnt  = readUint32(data + 32);
+    pHeader->typecnt  = readUint32(data + 36);
+    pHeader->charcnt  = readUint32(data + 40);
+    return true;
+}
+
+/**
+ * @brief Size of the data block following a TZif header.
+ * @param header
+ * @param timeSize 4 for the version 1 block, 8 for the version 2+ block.
+ * @return Size in bytes
+ */
+static uint64_t blockSize(const stTZifHeader& header, uint64_t timeSize)
+{
+    return header.timecnt * timeSize + header.timecnt + header.typecnt * 6 + header.charcnt
+         + header.leapcnt * (timeSize + 4) + header.isstdcnt + header.isutcnt;
+}
+
+/**
+ * @brief Constructor, the zone is UTC until a zone is loaded.
+ */
+cZoneInfo::cZoneInfo()
+{
+}
+
+/**
+ * @brief Loads a zone by name or file path.
+ * Names (e.g. "Europe/Berlin") are searched within the directory of the environment variable TZDIR or /usr/share/zoneinfo.
+ * Paths beginning with '/', '\\' or '.' or containing ':' are used as given.
+ * @param zoneName
+ * @return true on success. The previously loaded zone is discarded in any case.
+ */
+bool cZoneInfo::load(const std::string& zoneName)
+{
+    std::string path = zoneName;
+    if (zoneName.empty() || (zoneName[0] != '/' && zoneName[0] != '\\' && zoneName[0] != '.' && zoneName.find(':') == std::string::npos))
+    {
+        const char* directory = getenv("TZDIR");
+        path = std::string((directory && *directory) ? directory : LibCpp_ZONEINFODIRECTORY) + "/" + zoneName;
+    }
+
+    std::vector<uint8_t> content;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file)
+    {
+        uint8_t buffer[4096];
+        size_t length;
+        while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0)
+            content.insert(content.end(), buffer, buffer + length);
+        fclose(file);
+    }
+    if (!parse(content.data(), content.size())) return false;
+    _name = zoneName;
+    return true;
+}
+
+/**
+ * @brief Loads a zone from the content of a TZif file (RFC 8536, version 1, 2 or 3).
+ * Version 2+ files are read from their 64 bit block including the footer rule.
+ * @param data
+ * @param size
+ * @return true on success, false if the data is no valid TZif content. The previously loaded zone is discarded in any case.
+ */
+bool cZoneInfo::parse(const uint8_t* data, size_t size)
+{
+    clear();
+    stTZifHeader header;
+    if (!data || !readHeader(data, size, &header)) return false;
+    const uint8_t* block = data + LibCpp_TZIFHEADERSIZE;
+    const uint8_t* end = data + size;
+    uint64_t timeSize = 4;
+    uint64_t length = blockSize(header, timeSize);
+    if (length > (uint64_t)(end - block)) return false;
+    if (header.version >= '2')
+    {   // skip the version 1 block, use the 64 bit block
+        const uint8_t* second = block + length;
+        if (!readHeader(second, (size_t)(end - second), &header)) return false;
+        block = second + LibCpp_TZIFHEADERSIZE;
+        timeSize = 8;
+        length = blockSize(header, timeSize);
+        if (length > (uint64_t)(end - block)) return false;
+    }
+    if (header.typecnt == 0 || header.typecnt > 256 || header.charcnt == 0) return false;
+
+    const uint8_t* times   = block;
+    const uint8_t* indexes = times + header.timecnt * timeSize;
+    const uint8_t* types   = indexes + header.timecnt;
+    const uint8_t* names   = types + header.typecnt * 6;
+
+    _transitions.resize((size_t)header.timecnt);
+    _typeIndexes.resize((size_t)header.timecnt);
+    for (size_t i=0; i<_transitions.size(); i++)
+    {
+        _transitions[i] = (timeSize == 8) ? readInt64(times + i * 8) : (int64_t)(int32_t)readUint32(times + i * 4);
+        _typeIndexes[i] = indexes[i];
+        if (indexes[i] >= header.typecnt || (i > 0 && _transitions[i] <= _transitions[i-1]))
+        {
+            clear();
+            return false;
+        }
+    }
+    _types.resize((size_t)header.typecnt);
+    for (size_t i=0; i<_types.size(); i++)
+    {
+        const uint8_t* entry = types + i * 6;
+        _types[i].utcOffset = (int32_t)readUint32(entry);
+        _types[i].dst       = entry[4] ? 1 : 0;
+        _types[i].nameIndex = entry[5];
+        if (entry[5] >= header.charcnt)
+        {
+            clear();
+            return false;
+        }
+    }
+    _names.assign((const char*)names, (size_t)header.charcnt);
+    _names.push_back('\0');
+
+    if (timeSize == 8)
+    {   // footer "\n<POSIX TZ string>\n"
+        const char* footer = (const char*)(block + length);
+        const char* footerEnd = (const char*)end;
+        if (footer < footerEnd && *footer == '\n')
+        {
+            const char* ruleEnd = (const char*)memchr(footer + 1, '\n', (size_t)(footerEnd - footer - 1));
+            if (ruleEnd)
+                _rule.assign(footer + 1, ruleEnd);
+        }
+    }
+    if (!_rule.empty() && _zoneRule.parse(_rule))
+    {
+        _ruleTypes[0] = {_zoneRule.standardOffset(), 0, nameIndex(_zoneRule.standardName())};
+        _ruleTypes[1] = {_zoneRule.dstOffset(), 1, nameIndex(_zoneRule.dstName())};
+    }
+    return true;
+}
+
+/**
+ * @brief Discards the loaded zone.
+ */
+void cZoneInfo::clear()
+{
+    _name.clear();
+    _transitions.clear();
+    _typeIndexes.clear();
+    _types.clear();
+    _names.clear();
+    _rule.clear();
+    _zoneRule = cZoneRule();
+}
+
+/**
+ * @brief Index of an abbreviation within the abbreviations of the zone.
+ * Missing abbreviations are appended as long as the index fits into stZoneType::nameIndex.
+ * @param name
+ * @return Index, the index of the empty abbreviation if the name does not fit
+ */
+uint8_t cZoneInfo::nameIndex(const std::string& name)
+{
+    std::string key = name;
+    key.push_back('\0');
+    size_t index = _names.find(key);
+    if (index == std::string::npos && _names.size() <= 255)
+    {
+        index = _names.size();
+        _names += key;
+    }
+    if (index > 255) index = _names.find('\0');     // empty abbreviation behind the first one
+    return (uint8_t)index;
+}
+
+/**
+ * @brief Local time type valid at the given unix time.
+ * Before the first transition the first type is valid, after the last transition the type of the footer rule
+ * or, without footer, the type of the last transition.
+ * @param unixTime
+ * @return Local time type, UTC if no zone is loaded
+ */
+stZoneType cZoneInfo::type(time_t unixTime) const
+{
+    if (_types.empty()) return zoneTypeUTC;
+    if (_zoneRule.isValid() && (_transitions.empty() || (int64_t)unixTime >= _transitions.back()))
+        return _ruleTypes[_zoneRule.dst(unixTime)];
+    if (_transitions.empty() || (int64_t)unixTime < _transitions.front()) return _types[0];
+    size_t index = (size_t)(std::upper_bound(_transitions.begin(), _transitions.end(), (int64_t)unixTime) - _transitions.begin()) - 1;
+    return _types[_typeIndexes[index]];
+}
+
+/**
+ * @brief Abbreviation of a local time type.
+ * @param type Type received by type().
+ * @return Abbreviation, e.g. "CEST", "UTC" if no zone is loaded
+ */
+const char* cZoneInfo::abbreviation(const stZoneType& type) const
+{
+    if (_names.empty()) return "UTC";
+    return _names.c_str() + type.nameIndex;
+}
+
+/**
+ * @brief Calendar data of the zone at the given unix time.
+ * The calendar holds the geographic (standard time) zone and the dst, see calendarMath::offsetToCalendar().
+ * @param unixTime
+ * @return Calendar data
+ */
+stCalendar cZoneInfo::calendar(time_t unixTime) const
+{
+    stZoneType zoneType = type(unixTime);
+    return calendarMath::offsetToCalendar(unixTime, zoneType.utcOffset, zoneType.dst);
+}
+
+/**
+ * @brief Returns the calendar data representation of the instance within a geographic zone of the time zone data base.
+ * @param zone Loaded zone, see cZoneInfo::load().
+ * @return Calendar data
+ */
+stCalendar cTime::calendar(const cZoneInfo& zone)
+{
+    stCalendar result = zone.calendar(_time);
+    result.nanoSeconds = _nanoSeconds;
+    return result;
+}
+
+/** @} */
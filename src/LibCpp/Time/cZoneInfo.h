@@ -0,0 +1,73 @@
+// utf-8 (ü)
+/**
+ * @file   cZoneInfo.h
+ * @author Olaf Simon
+ * @brief  Class LibCpp::cZoneInfo
+ *
+ * \addtogroup LibCpp_time
+ * @{
+**/
+
+#ifndef cZoneInfo_H
+#define cZoneInfo_H
+
+#include "cTime.h"
+#include "cZoneRule.h"
+
+#include <string>
+#include <vector>
+
+namespace LibCpp
+{
+
+/**
+ * @brief Local time type of a geographic zone (one entry of a TZif file).
+**/
+typedef struct _stZoneType
+{
+    int32_t utcOffset;      ///< Seconds to add to UTC to receive the wall clock time
+    int8_t  dst;            ///< 1 = daylight saving time, 0 = standard time
+    uint8_t nameIndex;      ///< Index of the abbreviation (e.g. "CEST") within the abbreviations of the zone
+} stZoneType;
+
+/**
+ * @brief Geographic time zone loaded from the IANA time zone database (TZif files, e.g. /usr/share/zoneinfo/Europe/Berlin).
+ * The transitions are held as sorted array, thus a conversion is a binary search instead of
+ * setting the TZ environment variable and calling tzset() and localtime().
+**/
+class cZoneInfo
+{
+public:
+    cZoneInfo();                                                ///< Constructor, the zone is UTC until a zone is loaded.
+
+    bool load(const std::string& zoneName);                     ///< Loads a zone by name (e.g. "Europe/Berlin") or file path.
+    bool parse(const uint8_t* data, size_t size);               ///< Loads a zone from the content of a TZif file.
+    bool isValid() const { return !_types.empty(); }            ///< True if a zone is loaded.
+
+    const std::string& name() const { return _name; }           ///< Name given to load().
+    const std::string& rule() const { return _rule; }           ///< POSIX TZ string of the footer, valid after the last transition (e.g. "CET-1CEST,M3.5.0,M10.5.0/3").
+    const cZoneRule& zoneRule() const { return _zoneRule; }     ///< Parsed footer rule, invalid if the file has none.
+    size_t transitionCount() const { return _transitions.size(); } ///< Number of transitions.
+
+    stZoneType  type(time_t unixTime) const;                    ///< Local time type valid at the given unix time.
+    const char* abbreviation(const stZoneType& type) const;     ///< Abbreviation of a local time type, e.g. "CEST".
+    stCalendar  calendar(time_t unixTime) const;                ///< Calendar data of the zone at the given unix time.
+
+private:
+    void    clear();                    ///< Discards the loaded zone.
+    uint8_t nameIndex(const std::string& name); ///< Index of an abbreviation within _names, appended if missing.
+
+    std::string          _name;         ///< Name of the zone
+    std::vector<int64_t> _transitions;  ///< Unix times of the transitions, ascending
+    std::vector<uint8_t> _typeIndexes;  ///< Index into _types valid from the transition of the same index on
+    std::vector<stZoneType> _types;     ///< Local time types
+    std::string          _names;        ///< Abbreviations, each terminated by zero
+    std::string          _rule;         ///< POSIX TZ string of the footer
+    cZoneRule            _zoneRule;     ///< Parsed footer rule
+    stZoneType           _ruleTypes[2]; ///< Local time types of the footer rule (index = dst)
+};
+
+}
+#endif // cZoneInfo_H
+
+/** @} */
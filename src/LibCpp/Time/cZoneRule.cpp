@@ -0,0 +1,454 @@
+// utf-8 (ü)
+
+// MIT License
+// Copyright © 2023 Olaf Simon
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+/**
+ * @file   cZoneRule.cpp
+ * @author Olaf Simon
+ * @brief  Time zones defined by POSIX TZ strings of class LibCpp::cZoneRule
+ *
+ * \addtogroup LibCpp_time
+ * @{
+ *
+ * A POSIX TZ string (IEEE 1003.1, e.g. "CET-1CEST,M3.5.0,M10.5.0/3") defines the UTC offsets of the
+ * standard and the daylight saving time and the dates of the dst transitions. cZoneRule evaluates such
+ * a string without the TZ environment variable, tzset() or localtime(): the transitions of a year are
+ * calculated by daysFromCivil() and kept within a small per year cache, thus a conversion is
+ * one cache lookup and two comparisons.
+ *
+ * \code
+ * cZoneRule sydney("AEST-10AEDT,M10.1.0,M4.1.0/3");
+ * stCalendar cal = cTime::now().calendar(sydney);
+ * printf("%s\n", cTime::toString(cal).c_str());        // 2023-09-21#01:17:38#STD#+10:00
+ *
+ * stCalendar wallClock = stCalendar_Invalid;            // no zone and dst: wall clock time of the rule
+ * wallClock.year = 2023; wallClock.month = 12; wallClock.day = 24;
+ * wallClock.hour = 0; wallClock.minute = 0; wallClock.second = 0;
+ * cTime christmasEve = cTime::set(wallClock, sydney);  // 2023-12-23#13:00:00 UTC
+ * \endcode
+ *
+ * Supported are names of at least three letters or quoted by angle brackets (e.g. "<+1030>"), offsets
+ * [+|-]hh[:mm[:ss]] (positive west of Greenwich) and the date forms Jn, n and Mm.w.d followed by an optional
+ * /time of -167 till 167 hours (RFC 8536 extension). A dst without rule uses the US rule "M3.2.0,M11.1.0".
+ * cZoneInfo evaluates the rule of the footer of a TZif file after its last transition.
+**/
+
+#include "cZoneRule.h"
+#include "cCalendarMath.h"
+
+#include <cctype>
+
+using namespace LibCpp;
+
+#define LibCpp_RULECACHEBIAS  (1 << 20)     ///< Bias of the cached transition times, covers transitions up to 12 days before the begin of the year
+#define LibCpp_RULECACHEMASK  ((1 << 25) - 1)   ///< Mask of a cached transition time (seconds after the begin of the year plus bias)
+#define LibCpp_RULECACHEYEARS 1899          ///< Years of the cache key are stored as year - 1899, thus 1900 till 18282
+
+static const stRuleDate ruleDateUS[2] = {{'M', 0, 3, 2, 2 * LibCpp_SECONDSPERHOUR}, {'M', 0, 11, 1, 2 * LibCpp_SECONDSPERHOUR}}; ///< Default transitions of a dst without rule
+
+/**
+ * @brief Parses a zone abbreviation, either at least three letters or quoted by angle brackets.
+ * @param p
+ * @param pName [output]
+ * @return Position behind the name, nullptr on failure
+ */
+static const char* parseName(const char* p, std::string* pName)
+{
+    const char* begin = p;
+    if (*p == '<')
+    {
+        begin = ++p;
+        while (*p && *p != '>') p++;
+        if (*p != '>' || p - begin < 3) return nullptr;
+        pName->assign(begin, p);
+        return p + 1;
+    }
+    while (isalpha((unsigned char)*p)) p++;
+    if (p - begin < 3) return nullptr;
+    pName->assign(begin, p);
+    return p;
+}
+
+/**
+ * @brief Parses a decimal number.
+ * @param p
+ * @param min
+ * @param max
+ * @param pValue [output]
+ * @return Position behind the number, nullptr if there is no number within [min, max]
+ */
+static const char* parseNumber(const char* p, int32_t min, int32_t max, int32_t* pValue)
+{
+    if (!isdigit((unsigned char)*p)) return nullptr;
+    int32_t value = 0;
+    while (isdigit((unsigned char)*p))
+    {
+        value = value * 10 + (*p - '0');
+        if (value > max) return nullptr;
+        p++;
+    }
+    if (value < min) return nullptr;
+    *pValue = value;
+    return p;
+}
+
+/**
+ * @brief Parses a time or an offset [+|-]hh[:mm[:ss]].
+ * @param p
+ * @param maxHours 24 for offsets, 167 for transition times
+ * @param pSeconds [output]
+ * @return Position behind the time, nullptr on failure
+ */
+static const char* parseTime(const char* p, int32_t maxHours, int32_t* pSeconds)
+{
+    int32_t sign = 1;
+    if (*p == '+' || *p == '-')
+    {
+        if (*p == '-') sign = -1;
+        p++;
+    }
+    int32_t hours = 0;
+    int32_t minutes = 0;
+    int32_t seconds = 0;
+    p = parseNumber(p, 0, maxHours, &hours);
+    if (p && *p == ':')
+    {
+        p = parseNumber(p + 1, 0, 59, &minutes);
+        if (p && *p == ':')
+            p = parseNumber(p + 1, 0, 59, &seconds);
+    }
+    if (!p) return nullptr;
+    *pSeconds = sign * (hours * LibCpp_SECONDSPERHOUR + minutes * LibCpp_SECONDSPERMINUTE + seconds);
+    return p;
+}
+
+/**
+ * @brief Parses a transition date Jn, n or Mm.w.d with optional /time.
+ * @param p
+ * @param pDate [output]
+ * @return Position behind the date, nullptr on failure
+ */
+static const char* parseDate(const char* p, stRuleDate* pDate)
+{
+    stRuleDate date = {'D', 0, 0, 0, 2 * LibCpp_SECONDSPERHOUR};
+    int32_t value = 0;
+    if (*p == 'M')
+    {
+        date.kind = 'M';
+        p = parseNumber(p + 1, 1, 12, &value);
+        date.month = (uint8_t)value;
+        if (p && *p == '.') p = parseNumber(p + 1, 1, 5, &value);
+        else p = nullptr;
+        date.week = (uint8_t)value;
+        if (p && *p == '.') p = parseNumber(p + 1, 0, 6, &value);
+        else p = nullptr;
+        date.day = (int16_t)value;
+    }
+    else if (*p == 'J')
+    {
+        date.kind = 'J';
+        p = parseNumber(p + 1, 1, 365, &value);
+        date.day = (int16_t)value;
+    }
+    else
+    {
+        p = parseNumber(p, 0, 365, &value);
+        date.day = (int16_t)value;
+    }
+    if (p && *p == '/') p = parseTime(p + 1, 167, &date.time);
+    if (!p) return nullptr;
+    *pDate = date;
+    return p;
+}
+
+/**
+ * @brief Day of a transition date within the given year.
+ * @param year
+ * @param date
+ * @return Days since 1.1.1970
+ */
+static int64_t ruleDay(int32_t year, const stRuleDate& date)
+{
+    int64_t newYear = calendarMath::daysFromCivil(year, 1, 1);
+    if (date.kind == 'J')
+        return newYear + date.day - 1 + ((date.day >= 60 && LibOb_isLeapYear(year)) ? 1 : 0);
+    if (date.kind == 'D')
+        return newYear + date.day;
+
+    int64_t first = calendarMath::daysFromCivil(year, date.month, 1);
+    int64_t weekday = calendarMath::floorModulo(first + 4, 7);     // 0 = sunday, 1.1.1970 was a thursday
+    int64_t day = first + (date.day - weekday + 7) % 7 + (date.week - 1) * 7;
+    if (date.week == 5)
+    {
+        int64_t next = calendarMath::daysFromCivil(year, date.month + 1, 1);
+        while (day >= next) day -= 7;
+    }
+    return day;
+}
+
+/**
+ * @brief Constructor, the rule is UTC until a rule is parsed.
+ */
+cZoneRule::cZoneRule()
+{
+    clear();
+}
+
+/**
+ * @brief Constructor parsing a POSIX TZ string.
+ * Check isValid() for success.
+ * @param rule e.g. "CET-1CEST,M3.5.0,M10.5.0/3"
+ */
+cZoneRule::cZoneRule(const std::string& rule)
+{
+    parse(rule);
+}
+
+/**
+ * @brief Copy constructor, the transition cache is not copied.
+ * @param rule
+ */
+cZoneRule::cZoneRule(const cZoneRule& rule)
+{
+    *this = rule;
+}
+
+/**
+ * @brief Assignment, the transition cache is not copied.
+ * @param rule
+ * @return *this
+ */
+cZoneRule& cZoneRule::operator=(const cZoneRule& rule)
+{
+    if (this == &rule) return *this;
+    _valid          = rule._valid;
+    _hasDst         = rule._hasDst;
+    _text           = rule._text;
+    _standardName   = rule._standardName;
+    _dstName        = rule._dstName;
+    _standardOffset = rule._standardOffset;
+    _dstOffset      = rule._dstOffset;
+    _dstBegin       = rule._dstBegin;
+    _dstEnd         = rule._dstEnd;
+    clearCache();
+    return *this;
+}
+
+/**
+ * @brief Parses a POSIX TZ string.
+ * Examples: "CET-1CEST,M3.5.0,M10.5.0/3", "EST5EDT,M3.2.0,M11.1.0", "<+1030>-10:30<+11>-11,M10.1.0,M4.1.0", "JST-9"
+ * @param rule
+ * @return true on success. The previously parsed rule is discarded in any case.
+ */
+bool cZoneRule::parse(const std::string& rule)
+{
+    clear();
+    std::string standardName;
+    std::string dstName;
+    int32_t offset = 0;
+    const char* p = parseName(rule.c_str(), &standardName);
+    if (p) p = parseTime(p, 24, &offset);
+    if (!p) return false;
+    int32_t standardOffset = -offset;       // POSIX offsets are positive west of Greenwich
+    int32_t dstOffset = standardOffset;
+    stRuleDate dstBegin = ruleDateUS[0];
+    stRuleDate dstEnd = ruleDateUS[1];
+    if (*p)
+    {
+        p = parseName(p, &dstName);
+        if (!p) return false;
+        dstOffset = standardOffset + LibCpp_SECONDSPERHOUR;
+        if (*p && *p != ',')
+        {
+            p = parseTime(p, 24, &offset);
+            if (!p) return false;
+            dstOffset = -offset;
+        }
+        if (*p == ',')
+        {
+            p = parseDate(p + 1, &dstBegin);
+            if (p && *p == ',') p = parseDate(p + 1, &dstEnd);
+            else p = nullptr;
+            if (!p) return false;
+        }
+        if (*p) return false;
+    }
+
+    _valid          = true;
+    _hasDst         = !dstName.empty();
+    _text           = rule;
+    _standardName   = standardName;
+    _dstName        = dstName;
+    _standardOffset = standardOffset;
+    _dstOffset      = dstOffset;
+    _dstBegin       = dstBegin;
+    _dstEnd         = dstEnd;
+    return true;
+}
+
+/**
+ * @brief Discards the parsed rule.
+ */
+void cZoneRule::clear()
+{
+    _valid          = false;
+    _hasDst         = false;
+    _text.clear();
+    _standardName   = "UTC";
+    _dstName.clear();
+    _standardOffset = 0;
+    _dstOffset      = 0;
+    _dstBegin       = ruleDateUS[0];
+    _dstEnd         = ruleDateUS[1];
+    clearCache();
+}
+
+/**
+ * @brief Discards the cached transitions.
+ */
+void cZoneRule::clearCache()
+{
+    for (int i=0; i<LibCpp_ZONERULECACHE; i++)
+        _cache[i].store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Unix times of the begin and end of the daylight saving time of a year.
+ * The transitions are calculated once per year and cached. A cache entry is a single 64 bit word
+ * (year and both transitions relative to the begin of the year), thus the cache is shared by all
+ * threads without lock.
+ * @param year
+ * @param pDstBegin [output] Begin of the dst, before the end within the northern hemisphere
+ * @param pDstEnd [output] End of the dst, before the begin within the southern hemisphere
+ * @return false if the rule has no daylight saving time (outputs unchanged)
+ */
+bool cZoneRule::transitions(int32_t year, time_t* pDstBegin, time_t* pDstEnd) const
+{
+    if (!_hasDst) return false;
+    int64_t newYear = calendarMath::daysFromCivil(year, 1, 1) * LibCpp_SECONDSPERDAY;
+    uint64_t key = (uint64_t)((int64_t)year - LibCpp_RULECACHEYEARS);
+    std::atomic<uint64_t>& slot = _cache[year & (LibCpp_ZONERULECACHE - 1)];
+    uint64_t entry = slot.load(std::memory_order_relaxed);
+    if (key > 0 && key < (1 << 14) && (entry >> 50) == key)
+    {
+        *pDstBegin = (time_t)(newYear + (int64_t)((entry >> 25) & LibCpp_RULECACHEMASK) - LibCpp_RULECACHEBIAS);
+        *pDstEnd   = (time_t)(newYear + (int64_t)(entry & LibCpp_RULECACHEMASK) - LibCpp_RULECACHEBIAS);
+        return true;
+    }
+
+    int64_t begin = ruleDay(year, _dstBegin) * LibCpp_SECONDSPERDAY + _dstBegin.time - _standardOffset;
+    int64_t end   = ruleDay(year, _dstEnd) * LibCpp_SECONDSPERDAY + _dstEnd.time - _dstOffset;
+    *pDstBegin = (time_t)begin;
+    *pDstEnd   = (time_t)end;
+
+    uint64_t beginEntry = (uint64_t)(begin - newYear + LibCpp_RULECACHEBIAS);
+    uint64_t endEntry   = (uint64_t)(end - newYear + LibCpp_RULECACHEBIAS);
+    if (key > 0 && key < (1 << 14) && beginEntry <= LibCpp_RULECACHEMASK && endEntry <= LibCpp_RULECACHEMASK)
+        slot.store((key << 50) | (beginEntry << 25) | endEntry, std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Daylight saving time at the given unix time.
+ * @param unixTime
+ * @return 1 if daylight saving time is valid, 0 otherwise
+ */
+int8_t cZoneRule::dst(time_t unixTime) const
+{
+    if (!_hasDst) return 0;
+    int32_t year = 0;
+    uint8_t month = 0;
+    uint8_t day = 0;
+    calendarMath::civilFromDays(calendarMath::floorDivision((int64_t)unixTime + _standardOffset, LibCpp_SECONDSPERDAY), &year, &month, &day);
+    time_t begin = 0;
+    time_t end = 0;
+    transitions(year, &begin, &end);
+    if (begin < end) return (unixTime >= begin && unixTime < end) ? 1 : 0;
+    return (unixTime >= begin || unixTime < end) ? 1 : 0;     // southern hemisphere
+}
+
+/**
+ * @brief Seconds to add to UTC to receive the wall clock time at the given unix time.
+ * @param unixTime
+ * @return Offset in seconds
+ */
+int32_t cZoneRule::utcOffset(time_t unixTime) const
+{
+    return dst(unixTime) ? _dstOffset : _standardOffset;
+}
+
+/**
+ * @brief Calendar data of the zone at the given unix time.
+ * The calendar holds the geographic (standard time) zone and the dst, see calendarMath::offsetToCalendar().
+ * @param unixTime
+ * @return Calendar data
+ */
+stCalendar cZoneRule::calendar(time_t unixTime) const
+{
+    int8_t isDst = dst(unixTime);
+    return calendarMath::offsetToCalendar(unixTime, isDst ? _dstOffset : _standardOffset, isDst);
+}
+
+/**
+ * @brief Unix time of a wall clock time of the zone.
+ * The time zone of the calendar is ignored. A dst of 0 or 1 selects the offset, otherwise the dst is resolved
+ * by the rule: the repeated hour at the end of the dst is taken as dst, the skipped hour at the begin
+ * of the dst is taken as standard time (e.g. 02:30 becomes 03:30 dst) like mktime() does.
+ * @param calendar Wall clock time, entries exceeding their range are carried over.
+ * @return unix time
+ */
+time_t cZoneRule::unixTime(const stCalendar& calendar) const
+{
+    time_t wallClock = calendarMath::unixTime(calendar.year, calendar.month, calendar.day, calendar.hour, calendar.minute, calendar.second);
+    time_t standardTime = wallClock - _standardOffset;
+    if (!_hasDst || calendar.dst == 0) return standardTime;
+    time_t dstTime = wallClock - _dstOffset;
+    if (calendar.dst == 1 || dst(dstTime)) return dstTime;
+    return standardTime;
+}
+
+/**
+ * @brief Returns the calendar data representation of the instance within a zone defined by a POSIX TZ string.
+ * @param rule Parsed rule, see cZoneRule::parse().
+ * @return Calendar data
+ */
+stCalendar cTime::calendar(const cZoneRule& rule)
+{
+    stCalendar result = rule.calendar(_time);
+    result.nanoSeconds = _nanoSeconds;
+    return result;
+}
+
+/**
+ * @brief Deliveres a cTime instance initialized with the calendar data input within a zone defined by a POSIX TZ string.
+ * A valid time zone of the calendar is used as given (see cTime::set(stCalendar)), otherwise the calendar is
+ * taken as wall clock time of the rule (see cZoneRule::unixTime()).
+ * @param calendar
+ * @param rule Parsed rule, see cZoneRule::parse().
+ * @return Created instance
+ */
+cTime cTime::set(stCalendar calendar, const cZoneRule& rule)
+{
+    int64_t nanoSeconds = (calendar.nanoSeconds < LibCpp_NANOSECONDSPERSECOND) ? calendar.nanoSeconds : 0;
+    if (calendar.timeZone.hours != INT8_INVALID)
+        return set(calendarToUnix(calendar), nanoSeconds);
+    return set(rule.unixTime(calendar), nanoSeconds);
+}
+
+/** @} */
@@ -0,0 +1,84 @@
+// utf-8 (ü)
+/**
+ * @file   cZoneRule.h
+ * @author Olaf Simon
+ * @brief  Class LibCpp::cZoneRule
+ *
+ * \addtogroup LibCpp_time
+ * @{
+**/
+
+#ifndef cZoneRule_H
+#define cZoneRule_H
+
+#include "cTime.h"
+
+#include <atomic>
+#include <string>
+
+namespace LibCpp
+{
+
+#define LibCpp_ZONERULECACHE 128    ///< Number of years held by the transition cache of a rule (power of 2, 1970 till 2097 without collision)
+
+/**
+ * @brief Date and time of a dst transition of a POSIX TZ rule.
+**/
+typedef struct _stRuleDate
+{
+    char    kind;           ///< 'J' = day 1-365 without leap day (Jn), 'D' = day 0-365 with leap day (n), 'M' = week and day of a month (Mm.w.d)
+    int16_t day;            ///< Day of the year ('J', 'D') or day of the week 0-6 as 0 for sunday ('M')
+    uint8_t month;          ///< Month 1-12 ('M')
+    uint8_t week;           ///< Week 1-5 of the month, 5 = last week ('M')
+    int32_t time;           ///< Local time of the transition in seconds after midnight, -167 till 167 hours
+} stRuleDate;
+
+/**
+ * @brief Time zone defined by a POSIX TZ string, e.g. "CET-1CEST,M3.5.0,M10.5.0/3".
+ * The dst transitions of any year are calculated arithmetically and held within a small lock free
+ * per year cache, thus a conversion needs neither the TZ environment variable nor a time zone data base.
+**/
+class cZoneRule
+{
+public:
+    cZoneRule();                                                ///< Constructor, the rule is UTC until a rule is parsed.
+    cZoneRule(const std::string& rule);                         ///< Constructor parsing a POSIX TZ string.
+    cZoneRule(const cZoneRule& rule);                           ///< Copy constructor, the transition cache is not copied.
+    cZoneRule& operator=(const cZoneRule& rule);                ///< Assignment, the transition cache is not copied.
+
+    bool parse(const std::string& rule);                        ///< Parses a POSIX TZ string.
+    bool isValid() const { return _valid; }                     ///< True if a rule is parsed.
+    bool hasDst() const { return _hasDst; }                     ///< True if the rule has daylight saving time.
+
+    const std::string& text() const { return _text; }           ///< POSIX TZ string given to parse().
+    const std::string& standardName() const { return _standardName; } ///< Abbreviation of the standard time, e.g. "CET".
+    const std::string& dstName() const { return _dstName; }     ///< Abbreviation of the daylight saving time, e.g. "CEST".
+    int32_t standardOffset() const { return _standardOffset; }  ///< Seconds to add to UTC to receive the standard time.
+    int32_t dstOffset() const { return _dstOffset; }            ///< Seconds to add to UTC to receive the daylight saving time.
+
+    bool       transitions(int32_t year, time_t* pDstBegin, time_t* pDstEnd) const; ///< Unix times of the begin and end of the dst of a year.
+    int8_t     dst(time_t unixTime) const;                      ///< 1 if daylight saving time is valid at the given unix time, 0 otherwise.
+    int32_t    utcOffset(time_t unixTime) const;                ///< Seconds to add to UTC to receive the wall clock time at the given unix time.
+    stCalendar calendar(time_t unixTime) const;                 ///< Calendar data of the zone at the given unix time.
+    time_t     unixTime(const stCalendar& calendar) const;      ///< Unix time of a wall clock time of the zone.
+
+private:
+    void clear();                               ///< Discards the parsed rule.
+    void clearCache();                          ///< Discards the cached transitions.
+
+    bool        _valid;                         ///< A rule is parsed
+    bool        _hasDst;                        ///< The rule has daylight saving time
+    std::string _text;                          ///< POSIX TZ string
+    std::string _standardName;                  ///< Abbreviation of the standard time
+    std::string _dstName;                       ///< Abbreviation of the daylight saving time
+    int32_t     _standardOffset;                ///< UTC offset of the standard time in seconds
+    int32_t     _dstOffset;                     ///< UTC offset of the daylight saving time in seconds
+    stRuleDate  _dstBegin;                      ///< Begin of the daylight saving time (local standard time)
+    stRuleDate  _dstEnd;                        ///< End of the daylight saving time (local daylight saving time)
+    mutable std::atomic<uint64_t> _cache[LibCpp_ZONERULECACHE]; ///< Transitions of recently used years, see transitions()
+};
+
+}
+#endif // cZoneRule_H
+
+/** @} */
@@ -0,0 +1,190 @@
+// utf-8 (ü)
+
+// MIT License
+// Copyright © 2023 Olaf Simon
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+// and associated documentation files (the “Software”), to deal in the Software without restriction,
+// including without limitation the rights to use, copy, modify, merge, publish, distribute,
+// sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or
+// substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+// BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+/**
+ * @file   cZonedTime.cpp
+ * @author Olaf Simon
+ * @brief  Class LibCpp::cZonedTime
+ *
+ * \addtogroup LibCpp_time
+ * @{
+ *
+ * Events of several regions keep their own zone and dst:
+ * \code
+ * cZonedTime event = cZonedTime::set("2023-09-20#17:17:38#DST#-05:00");
+ * std::string text = event.toString();            // "2023-09-20#17:17:38#DST#-05:00" on any machine
+ * uint8_t hour = event.calendar().hour;           // 17
+ * bool earlier = event < cZonedTime::now();       // compares the instants
+ * \endcode
+ * The local zone is only consulted when an instant without zone is set (now(), set(cTime) or
+ * calendar data without zone). It is resolved once at this point and kept afterwards.
+**/
+
+#include "cZonedTime.h"
+#include "cCalendarMath.h"
+#include "cTimeFormat.h"
+
+using namespace LibCpp;
+
+/**
+ * @brief Constructor, unix time 0 as UTC.
+ */
+cZonedTime::cZonedTime()
+{
+    _zone = stTimeZone_Ini;
+    _dst = -1;
+}
+
+/**
+ * @brief Current time within the local zone.
+ * @return Created instance
+ */
+cZonedTime cZonedTime::now()
+{
+    return set(cTime::now());
+}
+
+/**
+ * @brief Instant within the given zone.
+ * @param time
+ * @param zone Geographic time zone (dst = 0 or 1) or UTC relative time zone (dst = -1)
+ * @param dst
+ * @return Created instance
+ */
+cZonedTime cZonedTime::set(cTime time, stTimeZone zone, int8_t dst)
+{
+    cZonedTime result;
+    result._time = time;
+    result._zone = zone;
+    result._dst = (dst == 0 || dst == 1) ? dst : -1;
+    return result;
+}
+
+/**
+ * @brief Instant within the local zone valid at that time.
+ * The zone and dst are those of cTime::calendar(), they match the UTC offset of the instant even if its
+ * standard offset differs from today's one. Offsets with seconds (local mean time) are kept with minute resolution.
+ * @param time
+ * @return Created instance
+ */
+cZonedTime cZonedTime::set(cTime time)
+{
+    stCalendar calendar = time.calendar();
+    return set(time, calendar.timeZone, calendar.dst);
+}
+
+/**
+ * @brief Calendar data keeping its zone and dst.
+ * Calendar data without zone is taken as local wall clock time (see cTime::set(stCalendar)).
+ * @param calendar
+ * @return Created instance
+ */
+cZonedTime cZonedTime::set(const stCalendar& calendar)
+{
+    if (calendar.timeZone.hours == INT8_INVALID)
+        return set(cTime::set(calendar));
+    return set(cTime::set(calendar), calendar.timeZone, calendar.dst);
+}
+
+/**
+ * @brief Calendar string keeping its zone and dst.
+ * A \ref GZC string of the fixed layout is scanned without the struct tm conversion.
+ * @param dateString
+ * @param format Format string, see LibOb_strptime
+ * @return Created instance
+ */
+cZonedTime cZonedTime::set(std::string_view dateString, const std::string& format)
+{
+    if ((format.empty() || format == LibOb_DEFAULTFORMAT) && dateString.size() == LibCpp_GZCLENGTH)
+    {
+        cPackedTime packed = cPackedTime::set(dateString);
+        if (packed.isValid()) return set(packed);
+    }
+    return set(cTime::fromString(dateString, format));
+}
+
+/**
+ * @brief Unpacks a packed time stamp.
+ * @param packed
+ * @return Created instance, unix time 0 as UTC if the packed time is invalid
+ */
+cZonedTime cZonedTime::set(cPackedTime packed)
+{
+    if (!packed.isValid()) return cZonedTime();
+    return set(cTime::set(packed.unixTime()), packed.timeZone(), packed.dst());
+}
+
+/**
+ * @brief Calendar data within the kept zone. No library functions are called.
+ * @return calendar struct
+ */
+stCalendar cZonedTime::calendar() const
+{
+    stCalendar calendar = cTime::unixToCalendar(_time.time(), _zone, _dst);
+    calendar.nanoSeconds = _time.nanoSeconds();
+    return calendar;
+}
+
+/**
+ * @brief String within the kept zone.
+ * The default format is written without the struct tm conversion.
+ * @param format Format string, see LibOb_strftime
+ * @param pLanguage
+ * @return String
+ */
+std::string cZonedTime::toString(const std::string& format, enLanguage* pLanguage) const
+{
+    if (format.empty() || format == LibOb_DEFAULTFORMAT)
+        return cTime::toString(calendar(), LibCpp_TIMEFORMAT(""), pLanguage);
+    return cTime::toString(calendar(), format, pLanguage);
+}
+
+/**
+ * @brief Packs the time stamp into 64 bits, the nano seconds are dropped.
+ * @return Packed time, invalid if the zone is not a multiple of 15 minutes
+ */
+cPackedTime cZonedTime::packed() const
+{
+    return cPackedTime::set(_time.time(), _zone, _dst);
+}
+
+/**
+ * @brief Same instant, zone and dst.
+ * @param a
+ * @return true if equal
+ */
+bool cZonedTime::operator==(const cZonedTime& a) const
+{
+    return _time.time() == a._time.time() && _time.nanoSeconds() == a._time.nanoSeconds()
+        && _zone.hours == a._zone.hours && _zone.minutes == a._zone.minutes && _dst == a._dst;
+}
+
+/**
+ * @brief Earlier instant, the zones are not regarded.
+ * @param a
+ * @return true if earlier
+ */
+bool cZonedTime::operator<(const cZonedTime& a) const
+{
+    return _time.time() < a._time.time() || (_time.time() == a._time.time() && _time.nanoSeconds() < a._time.nanoSeconds());
+}
+
+/** @} */
@@ -0,0 +1,62 @@
+// utf-8 (ü)
+/**
+ * @file   cZonedTime.h
+ * @author Olaf Simon
+ * @brief  Class LibCpp::cZonedTime
+ *
+ * \addtogroup LibCpp_time
+ * @{
+**/
+
+#ifndef cZonedTime_H
+#define cZonedTime_H
+
+#include "cTime.h"
+#include "cPackedTime.h"
+
+#include <string>
+#include <string_view>
+
+namespace LibCpp
+{
+
+/**
+ * @brief Instant together with the time zone and dst it was given in.
+ * cTime keeps the instant only and calendar() derives zone and dst from the local clock settings.
+ * A cZonedTime keeps the zone and dst of its origin (e.g. the calendar data or \ref GZC string of an
+ * event of another region), thus calendar() and toString() reproduce the original wall clock time by
+ * arithmetic only, without libc calls and without cTime::localTimeZone().
+**/
+class cZonedTime
+{
+public:
+    cZonedTime();                                                               ///< Constructor, unix time 0 as UTC.
+
+    static cZonedTime now();                                                    ///< Current time within the local zone, the zone is resolved once.
+    static cZonedTime set(cTime time, stTimeZone zone, int8_t dst);             ///< Instant within the given zone.
+    static cZonedTime set(cTime time);                                          ///< Instant within the local zone valid at that time, the zone is resolved once.
+    static cZonedTime set(const stCalendar& calendar);                          ///< Calendar data keeping its zone and dst, the local zone if none is given.
+    static cZonedTime set(std::string_view dateString, const std::string& format = ""); ///< Calendar string keeping its zone and dst (see cTime::fromString).
+    static cZonedTime set(cPackedTime packed);                                  ///< Unpacks a packed time stamp.
+
+    cTime       time() const { return _time; }                                  ///< Instant.
+    stTimeZone  timeZone() const { return _zone; }                              ///< Geographic time zone (dst = 0 or 1) or UTC relative time zone (dst = -1).
+    int8_t      dst() const { return _dst; }                                    ///< 1 = DST, 0 = STD, -1 = UTC relative zone.
+    stCalendar  calendar() const;                                               ///< Calendar data within the kept zone. Pure arithmetic.
+    std::string toString(const std::string& format = "", enLanguage* pLanguage = &LibOb_GLOBALLANGUAGE) const; ///< String within the kept zone, see cTime::toString.
+    cPackedTime packed() const;                                                 ///< Packs the time stamp into 64 bits (seconds resolution).
+
+    bool operator==(const cZonedTime& a) const;                                 ///< Same instant, zone and dst.
+    bool operator!=(const cZonedTime& a) const { return !(*this == a); }        ///< operator !=
+    bool operator< (const cZonedTime& a) const;                                 ///< Earlier instant.
+
+private:
+    cTime      _time;       ///< Instant
+    stTimeZone _zone;       ///< Zone of the origin
+    int8_t     _dst;        ///< dst of the origin
+};
+
+}
+#endif // cZonedTime_H
+
+/** @} */
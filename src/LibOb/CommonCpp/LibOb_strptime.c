@@ -35,8 +35,8 @@
  * <tr><td colspan="2">
  * <tr><td>\%m    <td>month [01-12]
  * <tr><td>\%1m   <td>month [1-12]
- * <tr><td>\%b    <td>abbreviated month (e.g. Oct)
- * <tr><td>\%B    <td>full month (e.g. October)
+ * <tr><td>\%b    <td>abbreviated month (e.g. Oct), on reading full names and abbreviations of all languages are accepted (not case sensitive)
+ * <tr><td>\%B    <td>full month (e.g. October), read as \%b
  * <tr><td colspan="2">
  * <tr><td>\%d    <td>day (of the month) [01-31]
  * <tr><td>\%1d   <td>day (of the month) [1-31]
@@ -51,15 +51,17 @@
  * <tr><td>\%M    <td>minute [00 - 59]
  * <tr><td>\%1M   <td>minute [0 - 59]
  * <tr><td colspan="2">
- * <tr><td>\%S    <td>second [00 - 59]
+ * <tr><td>\%S    <td>second [00 - 59], on reading a following fraction (e.g. "38.125" or "38,125") is left to \%f
  * <tr><td>\%1S   <td>second [0 - 59]
+ * <tr><td>\%f    <td>fraction of the second as 6 digits (microseconds), on reading any number of digits (see LibOb_strftimeNano, LibOb_strnptimeNano)
+ * <tr><td>\%3f   <td>fraction of the second as 1 - 9 digits (e.g. \%3f milliseconds, \%9f nanoseconds)
  * <tr><td colspan="2">
  * <tr><td>\%U    <td>UTC / STD / DST where UTC indicates +0300 is UTC offset, STD standard time and +0300 is geographic time zone, DST is daylight saving time and +0300 is geographic time zone
- * <tr><td>\%z    <td>UTC time offset, e.g. +03:00 or geographic time zone (depending on tm_isdst)
- * <tr><td>\%Z    <td>Time zone abbreviation, e.g. (CEST for 'central european summer time')
+ * <tr><td>\%z    <td>UTC time offset, e.g. +03:00 or geographic time zone (depending on tm_isdst), on reading without a preceding dst tm_isdst is set to -1 (UTC offset)
+ * <tr><td>\%Z    <td>Time zone abbreviation, e.g. (CEST for 'central european summer time'), on reading tm_isdst is set to the dst of the abbreviation
  * <tr><td colspan="2">
- * <tr><td>\%a    <td>abbreviated week day name [not evaluated on reading operation], e.g. 'Fri' or 'So'
- * <tr><td>\%A    <td>full week day name [not evaluated on reading operation]
+ * <tr><td>\%a    <td>abbreviated week day name, e.g. 'Fri' or 'So', on reading full names and abbreviations of all languages are accepted (not case sensitive)
+ * <tr><td>\%A    <td>full week day name, read as \%a
  * <tr><td>\%j    <td>day of year [not evaluated on reading operation]
  * <tr><td>[\%V]  <td>[not implemented yet] calendar week [00-53], 0=remaining week of previous year [not evaluated on reading operation, as can be calculated on other information], (week specified according to ISO 8601 - weed from mo to su, 1st week of the year includes first Thursday and 4th of January) [not evaluated on reading operation. Can be calculated on other information]
  * <tr><td>[\%1V] <td>[not implemented yet] calendar week [0, 1 ..., 53]
@@ -142,9 +144,13 @@
 
 #include <sec_api/string_s.h>
 #include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdatomic.h>
 #include "LibOb_strptime.h"
 
 #define ZONE_SIZE 67                            ///< Number of used named time zones.
+#define ZONE_QUARTERHOURS (27*4)                ///< Number of quarter hours from -12:00 to +14:45.
 #define LibCpp_SECONDSPERHOUR 3600              ///< Constant.
 
 /* enLanguage dependent constant definitions ------------------------------------------------------------------------------ */
@@ -166,17 +172,53 @@ const char* dayNameAbbreviations[enLanguageSize][8] =   ///< Day name abbreviati
 const char* monthNames[enLanguageSize][13] =            ///< Month names.
 {
     {"", "January", "February", "March", "April", "May", "June", "July", "August", "September", "October", "November", "December"},
-    {"", "Januar", "Februar", "Maerz", "April", "Mai", "Juni", "July", "August", "September", "Oktober", "November", "Dezember"}
+    {"", "Januar", "Februar", "Maerz", "April", "Mai", "Juni", "Juli", "August", "September", "Oktober", "November", "Dezember"}
 };
 
 const char* monthNameAbbreviations[enLanguageSize][13] =    ///< Month name abbreviations
 {
-    {"", "Jan", "Feb", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"},
-    {"", "Jan", "Feb", "Mai", "Jun", "Jul", "Aug", "Sepr", "Okt", "Nov", "Dez"}
- };
+    {"", "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"},
+    {"", "Jan", "Feb", "Mrz", "Apr", "Mai", "Jun", "Jul", "Aug", "Sep", "Okt", "Nov", "Dez"}
+};
 
 const char* dstNames[3] = {"UTC", "STD", "DST"};                       ///< Strings used for dst codes
 
+/**
+ * @brief Entry of the hash table of month and day names.
+**/
+typedef struct _stNameEntry
+{
+    const char* name;       ///< Name out of the name arrays, zero for an empty slot
+    uint8_t length;         ///< Length of name
+    uint8_t month;          ///< Month 1-12, 0 for day names
+    uint8_t day;            ///< Day within the week 1-7, 0 for month names
+} stNameEntry;
+
+/**
+ * @brief Field of a calendar string assigned by scanCalendar(), see scanCalendarTokens().
+**/
+typedef struct _stCalendarToken
+{
+    const char* begin;      ///< First character of the field
+    const char* end;        ///< Character following the field
+    char symbol;            ///< Format symbol reading the field the same way, 'p' for PM
+} stCalendarToken;
+
+#define CALENDARTOKENS 16                                               ///< Maximum number of fields recorded by scanCalendarTokens()
+
+/**
+ * @brief Fields of a calendar string in the order assigned by scanCalendar().
+**/
+typedef struct _stCalendarTokens
+{
+    int count;                                  ///< Number of fields, larger than CALENDARTOKENS if fields have been dropped
+    stCalendarToken tokens[CALENDARTOKENS];     ///< Fields
+} stCalendarTokens;
+
+#define NAMEHASH_SIZE (enLanguageSize*64)                               ///< Slots of nameHashTable, at least the double of the names (38 per language)
+static stNameEntry nameHashTable[NAMEHASH_SIZE];                        ///< Month and day names of all languages, full names and abbreviations, see findName()
+static atomic_int nameHashState = 0;                                    ///< 0 = nameHashTable empty, 1 = being built, 2 = ready
+
 /** List of time zone abbreviations */
 const stZoneAbbreviation zones[ZONE_SIZE] =
 {
@@ -194,6 +236,17 @@ const stZoneAbbreviation zones[ZONE_SIZE] =
     {"MIT", 0, {-9,30}}
 };                                                                      ///< List of zone names, dst and zone data.
 
+/*
+ * Lookup tables of 'zones', built out of 'zones' on the first lookup (see buildZoneTables()).
+ * zoneHashTable is indexed by zoneHash() of the name with linear probing, for the names of 'zones' each slot is
+ * mostly hit first. zoneOffsetTable is indexed directly by the zone in quarter hours and dst.
+ * For names and zones occurring twice (GST, NZDT) both tables hold the first entry, as the former linear search did.
+ */
+#define ZONEHASH_SIZE 256                                                       ///< Slots of zoneHashTable, at least the double of ZONE_SIZE
+static uint8_t zoneHashTable[ZONEHASH_SIZE];                                    ///< zones index + 1 by zoneHash() of the name, 0 for an empty slot
+static uint8_t zoneOffsetTable[ZONE_QUARTERHOURS][2];                           ///< zones index + 1 by quarter hour index (hours+12)*4 + minutes/15 and dst, 0 for no entry
+static atomic_int zoneTableState = 0;                                           ///< 0 = zone tables empty, 1 = being built, 2 = ready
+
 /* Constants ------------------------------------------------------------------------------ */
 const uint8_t DAYSOFMONTH[2][13] =                                                          ///< List of days within a month
     {{0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31},
@@ -209,12 +262,10 @@ const stZoneAbbreviation stZoneAbbreviation_Invalid = {"INVAL", INT8_INVALID, {I
 const char* unnamedZone = "None";                                               ///< Sting used as name in stZoneAbbreviation in case no time zone name exists.
 
 //! @cond Doxygen_Suppress
-int8_t      scanDst(const char* dstStr, int startsWith);
-const char* scanTimeZone(const char* name, stTimeZone* pTimeZone);
-const char* scanZone(const char* name, stZoneAbbreviation* pResultZone);
-const char* scanTime(const char* source, struct tm* tp, stTimeZone* pTimeZone);
-const char* scanDate(const char* source, struct tm* tp, stTimeZone* pTimeZone);
-const char* scanCalendar(const char* source, struct tm* tp, stTimeZone* pTimeZone);
+int8_t      scanDst(const char* dstStr, const char* dstEnd, int startsWith);
+const char* scanTimeZone(const char* name, const char* nameEnd, stTimeZone* pTimeZone);
+const char* scanZone(const char* name, const char* nameEnd, stZoneAbbreviation* pResultZone);
+const char* scanCalendar(const char* source, const char* sourceEnd, struct tm* tp, stTimeZone* pTimeZone);
 //! @endcond
 
 /* General string related scan functions -------------------------------------------------- */
@@ -232,7 +283,7 @@ const char* scanCalendar(const char* source, struct tm* tp, stTimeZone* pTimeZon
 enum enLanguage enLanguageIndex(enum enLanguage* pLanguage)
 {
     if (!pLanguage) return LibOb_GLOBALLANGUAGE;
-    if (*pLanguage>enLanguageSize) return enLanguage_en_US;
+    if (*pLanguage>=enLanguageSize) return enLanguage_en_US;
     return *pLanguage;
 }
 
@@ -250,14 +301,42 @@ int isnumber(unsigned char character)
     return character!=0 && (isdigit(character) || character==',' || character=='.'  || character=='+' || character=='-');
 }
 
+/**
+ * @brief Resolves the end of a source string
+ * All scan functions accept a pointer to the end of the source (first character not belonging to it).
+ * This allows scanning within larger buffers (e.g. memory mapped files) without copying or terminating the string.
+ * If 'sourceEnd' is zero, the source is a zero terminated character string.
+ * @param source Character string to be scanned.
+ * @param sourceEnd End of the source or zero.
+ * @return End of the source
+ */
+static const char* endOfSource(const char* source, const char* sourceEnd)
+{
+    return sourceEnd ? sourceEnd : source + strlen(source);
+}
+
+/**
+ * @brief Reads a character within the range [begin, end)
+ * @param position Position of the character.
+ * @param begin First character of the range.
+ * @param end End of the range.
+ * @return The character or 0 if 'position' is outside of the range.
+ */
+static char charAt(const char* position, const char* begin, const char* end)
+{
+    return (position>=begin && position<end) ? *position : 0;
+}
+
 /**
  * @brief Scans a character string until a non white space character is found
  * @param source Character string to be scanned.
+ * @param sourceEnd End of the source, zero for a zero terminated string.
  * @return Pointer to first character not being white space
  */
-const char* scipSpace(const char* source)
+const char* scipSpace(const char* source, const char* sourceEnd)
 {
-    while (isspace(*source)) source++;
+    sourceEnd = endOfSource(source, sourceEnd);
+    while (source<sourceEnd && isspace((unsigned char)*source)) source++;
     return source;
 }
 
@@ -265,32 +344,36 @@ const char* scipSpace(const char* source)
  * @brief Scans a character string until a non digit character is found
  * Accepts a sign '+' or '-' as digit at the first position. Used to scan past a integer number.
  * @param source Character string to be scanned.
+ * @param sourceEnd End of the source, zero for a zero terminated string.
  * @return Pointer to first character not being an digit
  */
-const char* scipDigits(const char* source)
+const char* scipDigits(const char* source, const char* sourceEnd)
 {
-    if (*source=='+' || *source=='-') source++;
-    while (isdigit(*source)) source++;
+    sourceEnd = endOfSource(source, sourceEnd);
+    if (source<sourceEnd && (*source=='+' || *source=='-')) source++;
+    while (source<sourceEnd && isdigit((unsigned char)*source)) source++;
     return source;
 }
 
 /**
  * @brief Scans a character string until a digit or letter character is found
  * @param source Character string to be scanned.
+ * @param sourceEnd End of the source, zero for a zero terminated string.
  * @param pType Pointer to an integer to store the value 1 in case a digit or 2 in case a letter is being detected. 0 if end of string is found. May be set to 0.
  * @return Pointer to first character being a digit or character letter or end of string (0);
  */
-const char* scipNonLetters(const char* source, int* pType)
+const char* scipNonLetters(const char* source, const char* sourceEnd, int* pType)
 {
-    while (*source != 0 && isnumber(*source) && !isdigit(*source)) source++;
-    while (*source != 0)
+    sourceEnd = endOfSource(source, sourceEnd);
+    while (source<sourceEnd && isnumber(*source) && !isdigit((unsigned char)*source)) source++;
+    while (source<sourceEnd)
     {
         if (isnumber(*source))
         {
             if (pType) *pType=1;
             return source;
         }
-        if (isupper(*source) || islower(*source))
+        if (isupper((unsigned char)*source) || islower((unsigned char)*source))
         {
             if (pType) *pType=2;
             return source;
@@ -301,6 +384,37 @@ const char* scipNonLetters(const char* source, int* pType)
     return source;
 }
 
+/**
+ * @brief Converts the digits of a (signed) number string
+ * Leading white space and one sign character are accepted (like sscanf() does).
+ * @param source Character string containing the number.
+ * @param sourceEnd End of the source.
+ * @param pNegative Output of the sign, set to 1 for a '-' sign.
+ * @param pValue Output of the absolute value. Overflows wrap around.
+ * @return Pointer to the first character following the digits. Zero if no digit is found.
+ */
+static const char* scanDigits(const char* source, const char* sourceEnd, int* pNegative, unsigned int* pValue)
+{
+    unsigned int value = 0;
+    const char* digits;
+    *pNegative = 0;
+    while (source<sourceEnd && isspace((unsigned char)*source)) source++;
+    if (source<sourceEnd && (*source=='+' || *source=='-'))
+    {
+        *pNegative = (*source=='-');
+        source++;
+    }
+    digits = source;
+    while (source<sourceEnd && (unsigned char)(*source-'0')<10)
+    {
+        value = value*10 + (unsigned int)(*source-'0');
+        source++;
+    }
+    if (source==digits) return 0;
+    *pValue = value;
+    return source;
+}
+
 /**
  * @brief Finds and converts a number string to a unsigned integer
  * If the number has a leading '+' and parameter allowPlus is false the number is not accepted as unsigned!
@@ -311,22 +425,28 @@ const char* scipNonLetters(const char* source, int* pType)
  * This way a 1. may be interpreted in the sense of 1st or as a float 1.0.
  * (This function following the sscanf() standard c++ function.)
  * @param source String containing the unsigned integer string.
+ * @param sourceEnd End of the source, zero for a zero terminated string.
  * @param result Pointer to unsigned integer to store the result.
  * @param scip If set, leading characters not being sign or digits are scipped.
  * @param allowPlus A number string beginning with a '+' character is accepted as unsigned int.
  * @param allowLaggingDot A lagging '.' character is allowed and not interpreted to indicate a float value.
  * @return Character pointer to the first sign not being consumed by the number conversion or nullptr if the converion failed.
  */
-const char* scanUint(const char* source, unsigned int* result, int scip, int allowPlus, int allowLaggingDot)
+const char* scanUint(const char* source, const char* sourceEnd, unsigned int* result, int scip, int allowPlus, int allowLaggingDot)
 {
-    char previousChar = *source;
-    while (scip && !isdigit(*source)) {previousChar = *source; source++;}
-    if (*source && (previousChar!='+' || allowPlus) && previousChar!='-')
+    char previousChar;
+    int negative;
+    unsigned int value;
+    sourceEnd = endOfSource(source, sourceEnd);
+    if (source>=sourceEnd) return 0;
+    previousChar = *source;
+    while (scip && source<sourceEnd && !isdigit((unsigned char)*source)) {previousChar = *source; source++;}
+    if (source<sourceEnd && (previousChar!='+' || allowPlus) && previousChar!='-')
     {
-        int res = sscanf_s(source, "%u", result);
-        if (res!=1) return 0;
-        source = scipDigits(source);
-        if (*source==0)
+        source = scanDigits(source, sourceEnd, &negative, &value);
+        if (!source) return 0;
+        *result = negative ? 0u-value : value;
+        if (source>=sourceEnd)
             return source;
         if (*source==',' || *source=='e' || *source=='E')
             return 0;
@@ -351,22 +471,28 @@ const char* scanUint(const char* source, unsigned int* result, int scip, int all
  * This way a 1. may be interpreted in the sense of 1st or as a float 1.0 .
  * (This function follows the sscanf() standard c++ function.)
  * @param source String containing the unsigned integer string.
+ * @param sourceEnd End of the source, zero for a zero terminated string.
  * @param result Pointer to unsigned integer to store the result.
  * @param scip If set, leading characters not being sign or digits are scipped.
  * @param requiredPlus If set only numbers starting with plus are interpreded as positive signed integer
  * @param allowLaggingDot A lagging '.', ',', 'e' or 'E' character is allowed and not interpreted to indicate a float value.
  * @return Character pointer to the first sign not being consumed by the number conversion or nullptr if the converion failed.
  */
-const char* scanInt(const char* source, int* result, int scip, int requiredPlus, int allowLaggingDot)
+const char* scanInt(const char* source, const char* sourceEnd, int* result, int scip, int requiredPlus, int allowLaggingDot)
 {
-    char previousChar = *source;
-    while (scip && !isdigit(*source)) {previousChar = *source; source++;}
-    if (*source && (previousChar=='-' || previousChar!='+' || !requiredPlus))
+    char previousChar;
+    int negative;
+    unsigned int value;
+    sourceEnd = endOfSource(source, sourceEnd);
+    if (source>=sourceEnd) return 0;
+    previousChar = *source;
+    while (scip && source<sourceEnd && !isdigit((unsigned char)*source)) {previousChar = *source; source++;}
+    if (source<sourceEnd && (previousChar=='-' || previousChar!='+' || !requiredPlus))
     {
-        int res = sscanf_s(source, "%d", result);         // atoi() is not standard C
-        if (res!=1) return 0;
-        source = scipDigits(source);
-        if (*source==0)
+        source = scanDigits(source, sourceEnd, &negative, &value);
+        if (!source) return 0;
+        *result = negative ? -(int)value : (int)value;
+        if (source>=sourceEnd)
             return source;
         if (*source=='.' || *source==',' || *source=='e' || *source=='E')
         {
@@ -382,26 +508,32 @@ const char* scanInt(const char* source, int* result, int scip, int requiredPlus,
 /**
  * @brief Scans source for an expression and copies it to destination
  * @param source
+ * @param sourceEnd End of the source, zero for a zero terminated string.
  * @param destination If destination is zero, the scan is executed but the expression is not copied.
  * @param destinationSize
  * @param scip If set, leading characters not being a begin of an expression (e.g. white space, numbers) are scipped.
  * @param allowNumber If set, after the first letter character following numbers are included into the expression
  * @return First character not part of the expression (or not being scanned due to undersized destination). Zero in case no expression is found.
  */
-const char* scanExpression(const char* source, char* destination, size_t destinationSize, int scip, int allowNumber)
+const char* scanExpression(const char* source, const char* sourceEnd, char* destination, size_t destinationSize, int scip, int allowNumber)
 {
     size_t cnt=0;
-    while (scip && !(isupper(*source) || islower(*source))) source++;
-    if (*source!=0)
+    sourceEnd = endOfSource(source, sourceEnd);
+    while (scip && source<sourceEnd && !(isupper((unsigned char)*source) || islower((unsigned char)*source))) source++;
+    if (source<sourceEnd)
     {
-        while ((isupper(*source) || islower(*source) || *source=='_' || (isdigit(*source) && allowNumber)) && cnt<destinationSize-2)
+        while (source<sourceEnd && (isupper((unsigned char)*source) || islower((unsigned char)*source) || *source=='_' || (isdigit((unsigned char)*source) && allowNumber))
+               && (!destination || cnt+2<destinationSize))
         {
-            *destination = *source;
-            destination++;
+            if (destination)
+            {
+                *destination = *source;
+                destination++;
+            }
             source++;
             cnt++;
         }
-        *destination = 0;
+        if (destination) *destination = 0;
         return source;
     }
     return 0;
@@ -432,13 +564,13 @@ const char* strcpyfmt(const char* formatBegin, char** pDestinationBegin, const c
  * @brief Checks characters from format string beginning at formatBegin being identical with the source string starting at sourceBegin until the next format escape sign '%' is found.
  * @param formatPosition Pointer to position within the format string.
  * @param ppSourcePosition Pointer to a pointer indicating the position within the source string.
+ * @param sourceEnd End of the source, zero for a zero terminated string.
  * @return Pointer to the format character (character after '%'). It points to zero in case the end of the format string is reached. The return value is zero in case the source content differs from the format content. *pSourcePosition is set to the position at which the next formatted data begins.
  */
-const char* strchkfmt(const char* formatPosition, const char** ppSourcePosition)
+const char* strchkfmt(const char* formatPosition, const char** ppSourcePosition, const char* sourceEnd)
 {
-    const char* sourceEnd;
     if (!ppSourcePosition) return 0;
-    sourceEnd = *ppSourcePosition + strlen(*ppSourcePosition);
+    sourceEnd = endOfSource(*ppSourcePosition, sourceEnd);
     while (*formatPosition!=0 && *formatPosition!='%' && *ppSourcePosition<sourceEnd)
     {
         if (*formatPosition != **ppSourcePosition) return 0;
@@ -486,11 +618,11 @@ int8_t LibOb_dst(const char* dstStr, int startsWith)
     int8_t dst;
     if (dstStr==0) return 0;
     if (*dstStr==0) return 0;
-    dst = scanDst(dstStr, startsWith);
+    dst = scanDst(dstStr, 0, startsWith);
     if (dst != (int8_t)0x80)
         return dst;
     strcpy_s(buffer, 8, dstStr);
-    scanZone(buffer, &zone);
+    scanZone(buffer, 0, &zone);
     if (zone.dst == (int8_t)0x80) return 0;
     return zone.dst;
 }
@@ -507,12 +639,93 @@ stTimeZone LibOb_timeZone(const char* timeZoneStr, int8_t* pDst)
     stZoneAbbreviation zone;
     if (timeZoneStr==0) return stTimeZone_Ini;
     if (*timeZoneStr==0) return stTimeZone_Ini;
-    scanZone(timeZoneStr, &zone);
+    scanZone(timeZoneStr, 0, &zone);
     if (zone.dst == (int8_t)0x80) return stTimeZone_Ini;
     if (pDst) *pDst = zone.dst;
     return zone.zone;
 }
 
+/**
+ * @brief Hash of a zone name for zoneHashTable.
+ * The first four characters, the last character and the length are combined and spread by a multiplication.
+ * @param name
+ * @param length Length of name, at least 1.
+ * @return Slot 0-255 of zoneHashTable
+ */
+static unsigned int zoneHash(const char* name, size_t length)
+{
+    uint32_t key = 0;
+    size_t i;
+    for (i=0; i<length && i<4; i++)
+        key |= (uint32_t)(unsigned char)name[i] << (8*i);
+    key ^= ((uint32_t)(unsigned char)name[length-1] << 3) ^ (uint32_t)length;
+    return (uint32_t)(key * 0x819D7CA7u) >> 24;
+}
+
+/**
+ * @brief Quarter hour index of a zone for zoneOffsetTable.
+ * @param timeZone
+ * @return (hours+12)*4 + minutes/15 or -1 if the zone is no quarter hour between -12:00 and +14:45
+ */
+static int zoneQuarterHour(stTimeZone timeZone)
+{
+    int index;
+    if (timeZone.minutes>=60 || timeZone.minutes%15) return -1;
+    index = (timeZone.hours+12)*4 + timeZone.minutes/15;
+    if (index<0 || index>=ZONE_QUARTERHOURS) return -1;
+    return index;
+}
+
+/**
+ * @brief Builds zoneHashTable and zoneOffsetTable out of 'zones' on the first call.
+ * Concurrent first calls wait for the thread building the tables.
+ */
+static void buildZoneTables(void)
+{
+    int expected = 0;
+    if (atomic_load_explicit(&zoneTableState, memory_order_acquire) == 2) return;
+    if (atomic_compare_exchange_strong(&zoneTableState, &expected, 1))
+    {
+        int i;
+        for (i=0; i<ZONE_SIZE; i++)
+        {
+            size_t length = strlen(zones[i].name);
+            unsigned int slot = zoneHash(zones[i].name, length);
+            int quarterHour = zoneQuarterHour(zones[i].zone);
+            while (zoneHashTable[slot] && strcmp(zones[zoneHashTable[slot]-1].name, zones[i].name) != 0)
+                slot = (slot + 1) % ZONEHASH_SIZE;
+            if (!zoneHashTable[slot])
+                zoneHashTable[slot] = (uint8_t)(i + 1);
+            if (quarterHour >= 0 && !zoneOffsetTable[quarterHour][zones[i].dst])
+                zoneOffsetTable[quarterHour][zones[i].dst] = (uint8_t)(i + 1);
+        }
+        atomic_store_explicit(&zoneTableState, 2, memory_order_release);
+    }
+    else
+        while (atomic_load_explicit(&zoneTableState, memory_order_acquire) != 2) {}
+}
+
+/**
+ * @brief Finds a zone abbreviation (e.g. CET) within the 'zones' array.
+ * @param name Zero terminated zone name.
+ * @return Index into 'zones' or -1 if 'name' is not found.
+ */
+static int findZone(const char* name)
+{
+    size_t length = strlen(name);
+    unsigned int slot;
+    buildZoneTables();
+    if (length == 0) return -1;
+    slot = zoneHash(name, length);
+    while (zoneHashTable[slot])
+    {
+        int index = zoneHashTable[slot] - 1;
+        if (strcmp(name, zones[index].name) == 0) return index;
+        slot = (slot + 1) % ZONEHASH_SIZE;
+    }
+    return -1;
+}
+
 /**
  * @brief Finds a zone name (e.g. CET) out of the 'zones' array.
  * This function might fail in case not entry in zones matches 'timeZone'.\n
@@ -523,11 +736,14 @@ stTimeZone LibOb_timeZone(const char* timeZoneStr, int8_t* pDst)
  */
 const char* findZoneName(stTimeZone timeZone, int8_t dst)
 {
+    int index;
     if (dst<0) return "UTC";
-    for (int i=0; i<ZONE_SIZE; i++)
-        if (zones[i].zone.hours == timeZone.hours && zones[i].zone.minutes == timeZone.minutes && zones[i].dst == dst)
-            return zones[i].name;
-    return 0;
+    if (dst>1) return 0;
+    index = zoneQuarterHour(timeZone);
+    if (index<0) return 0;
+    buildZoneTables();
+    index = zoneOffsetTable[index][dst];
+    return index ? zones[index-1].name : 0;
 }
 
 /**
@@ -557,18 +773,19 @@ void createZoneName(char* buffer, size_t bufferSize, stTimeZone timeZone, int8_t
  * The function works in the sense of 'strstartwith' if parameter 'startWith' is set
  * In this case only the first three characters are evaluated.
  * @param dstStr String indication the dst value as given in the dstString array.
+ * @param dstEnd End of the string, zero for a zero terminated string.
  * @param startsWith If set, only the first characters are evaluated.
  * @return dst Code of dst or 0x80 in case of failure
  */
-int8_t scanDst(const char* dstStr, int startsWith)
+int8_t scanDst(const char* dstStr, const char* dstEnd, int startsWith)
 {
     char buffer[8];
-    buffer[0] = dstStr[0];
-    buffer[1] = dstStr[1];
-    buffer[2] = dstStr[2];
-    buffer[3] = dstStr[3];
-    buffer[4] = 0;
-    if (startsWith) buffer[3] = 0;
+    size_t length = startsWith ? 3 : 4;
+    size_t i;
+    dstEnd = endOfSource(dstStr, dstEnd);
+    for (i=0; i<length && dstStr+i<dstEnd; i++)
+        buffer[i] = dstStr[i];
+    buffer[i] = 0;
     if (strcmp(buffer, dstNames[0])==0) return -1;
     if (strcmp(buffer, dstNames[1])==0) return 0;
     if (strcmp(buffer, dstNames[2])==0) return 1;
@@ -578,41 +795,45 @@ int8_t scanDst(const char* dstStr, int startsWith)
 /**
  * @brief Finds the time zone data from a given string like '+01', '+0115', '+01:15'
  * @param name Formatted time zone number string.
+ * @param nameEnd End of the string, zero for a zero terminated string.
  * @param pTimeZone stTimeZone as a result.
  * @return Pointer to a character pointer to store the position of the first character not being consumed. Zero in case of failure.
  */
-const char* scanTimeZone(const char* name, stTimeZone* pTimeZone)
+const char* scanTimeZone(const char* name, const char* nameEnd, stTimeZone* pTimeZone)
 {
-    if (pTimeZone) *pTimeZone = stTimeZone_Invalid;
-    const char* pos = name;
-    int len;
-    int hours = 0;
+    const char* pos;
+    const char* digits;
+    int negative = 0;
+    unsigned int hours = 0;
     unsigned int minutes = 0;
-    if ((len=sscanf_s(pos, "%d", &hours)))
+    if (pTimeZone) *pTimeZone = stTimeZone_Invalid;
+    nameEnd = endOfSource(name, nameEnd);
+    pos = scanDigits(name, nameEnd, &negative, &hours);
+    if (pos)
     {
-        pos = scipDigits(pos);
-        if (len >= 4)
+        digits = pos;
+        while (digits>name && isdigit((unsigned char)digits[-1])) digits--;
+        if (pos-digits >= 4)
         {
             if (pTimeZone)
             {
-                pTimeZone->hours = hours/100;
+                pTimeZone->hours = negative ? -(int)(hours/100) : (int)(hours/100);
                 pTimeZone->minutes = hours%100;
             }
             return pos;
         }
         else
         {
-            if (pTimeZone) pTimeZone->hours = hours;
-            if (*pos == ':')
+            if (pTimeZone) pTimeZone->hours = negative ? -(int)hours : (int)hours;
+            if (pos<nameEnd && *pos == ':')
             {
+                const char* scanResult;
                 pos++;
-                if ((len=sscanf_s(pos, "%u", &minutes)))
+                scanResult = scanDigits(pos, nameEnd, &negative, &minutes);
+                if (scanResult)
                 {
-                    pos = scipDigits(pos);
-                    if (len>0 && pTimeZone)
-                    {
-                        pTimeZone->minutes = minutes;
-                    }
+                    pos = scanResult;
+                    if (pTimeZone) pTimeZone->minutes = minutes;
                 }
                 return pos;
             }
@@ -626,43 +847,45 @@ const char* scanTimeZone(const char* name, stTimeZone* pTimeZone)
  * The time zone name might be either one of the abbreviations defined in the array 'zones'
  * like 'CET' or and extended expression like 'UTC#+02:15' or 'UCT +02:15'.
  * @param name Time zone abbreviation string or extended string.
+ * @param nameEnd End of the string, zero for a zero terminated string.
  * @param pResultZone stZoneAbbreviation of the given zone abbreviation. In case of failure the dst entry is set to 0x80.
  * @return Pointer to a character pointer to store the position of the first character not being consumed. Zero in case of failure.
  */
-const char* scanZone(const char* name, stZoneAbbreviation* pResultZone)
+const char* scanZone(const char* name, const char* nameEnd, stZoneAbbreviation* pResultZone)
 {
     int i;
     char buffer[16];
     const char* scanPosition;
     const char* scanResult;
     if (pResultZone) *pResultZone = stZoneAbbreviation_Invalid;
-    scanResult = scanExpression(name, buffer, 16, 0, 0);
+    nameEnd = endOfSource(name, nameEnd);
+    scanResult = scanExpression(name, nameEnd, buffer, 16, 0, 0);
     if (!scanResult)
     {
         if (pResultZone) *pResultZone = stZoneAbbreviation_Invalid;
         return 0;
     }
     scanPosition = scanResult;
-    for (i=0; i<ZONE_SIZE; i++)
-        if (strcmp(buffer, zones[i].name)==0)
-        {
-            if (pResultZone) *pResultZone = zones[i];
-            return scanPosition;
-        }
-    int8_t dst = scanDst(name, 1);
+    i = findZone(buffer);
+    if (i >= 0)
+    {
+        if (pResultZone) *pResultZone = zones[i];
+        return scanPosition;
+    }
+    int8_t dst = scanDst(name, nameEnd, 1);
     if (dst!=INT8_INVALID)
     {
         int type = 0;
         if (pResultZone) pResultZone->dst = dst;
-        scanPosition = scipNonLetters(scanPosition, &type);
+        scanPosition = scipNonLetters(scanPosition, nameEnd, &type);
         if (type == 1)
         {
             stTimeZone tz;
-            scanResult = scanTimeZone(scanPosition, &tz);
+            scanResult = scanTimeZone(scanPosition, nameEnd, &tz);
             if (scanResult)
             {
                 scanPosition = scanResult;
-                pResultZone->zone = tz;
+                if (pResultZone) pResultZone->zone = tz;
             }
         }
         return scanPosition;
@@ -671,36 +894,151 @@ const char* scanZone(const char* name, stZoneAbbreviation* pResultZone)
     return 0;
 }
 
+/**
+ * @brief Hash of a name for nameHashTable, not case sensitive (FNV-1a of the lower case characters).
+ * @param name
+ * @param length
+ * @return Hash value
+ */
+static uint32_t nameHash(const char* name, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    size_t i;
+    for (i=0; i<length; i++)
+        hash = (hash ^ (uint32_t)tolower((unsigned char)name[i])) * 16777619u;
+    return hash;
+}
+
+/**
+ * @brief Compares 'length' characters not being case sensitive.
+ * @return 1 if equal
+ */
+static int equalsIgnoringCase(const char* a, const char* b, size_t length)
+{
+    size_t i;
+    for (i=0; i<length; i++)
+        if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i])) return 0;
+    return 1;
+}
+
+/**
+ * @brief Inserts a month or day name into nameHashTable. Names already contained are not inserted again.
+ * @param name
+ * @param month Month 1-12, 0 for a day name
+ * @param day Day within the week 1-7, 0 for a month name
+ */
+static void insertName(const char* name, uint8_t month, uint8_t day)
+{
+    size_t length = strlen(name);
+    uint32_t slot;
+    if (length == 0 || length > 255) return;
+    slot = nameHash(name, length) % NAMEHASH_SIZE;
+    while (nameHashTable[slot].name)
+    {
+        if (nameHashTable[slot].length == length && equalsIgnoringCase(nameHashTable[slot].name, name, length)) return;
+        slot = (slot + 1) % NAMEHASH_SIZE;
+    }
+    nameHashTable[slot].name = name;
+    nameHashTable[slot].length = (uint8_t)length;
+    nameHashTable[slot].month = month;
+    nameHashTable[slot].day = day;
+}
+
+/**
+ * @brief Builds nameHashTable out of the name arrays of all languages on the first call.
+ * Concurrent first calls wait for the thread building the table.
+ */
+static void buildNameHash(void)
+{
+    int expected = 0;
+    if (atomic_load_explicit(&nameHashState, memory_order_acquire) == 2) return;
+    if (atomic_compare_exchange_strong(&nameHashState, &expected, 1))
+    {
+        int i, j;
+        for (i=0; i<enLanguageSize; i++)
+        {
+            for (j=1; j<=12; j++)
+            {
+                insertName(monthNames[i][j], (uint8_t)j, 0);
+                insertName(monthNameAbbreviations[i][j], (uint8_t)j, 0);
+            }
+            for (j=1; j<=7; j++)
+            {
+                insertName(dayNames[i][j], 0, (uint8_t)j);
+                insertName(dayNameAbbreviations[i][j], 0, (uint8_t)j);
+            }
+        }
+        atomic_store_explicit(&nameHashState, 2, memory_order_release);
+    }
+    else
+        while (atomic_load_explicit(&nameHashState, memory_order_acquire) != 2) {}
+}
+
+/**
+ * @brief Finds a month or day name (full name or abbreviation of any language, not case sensitive).
+ * @param name Name, not zero terminated.
+ * @param length Length of name.
+ * @param hash nameHash() of name.
+ * @return Table entry or zero if 'name' is unknown.
+ */
+static const stNameEntry* findName(const char* name, size_t length, uint32_t hash)
+{
+    uint32_t slot = hash % NAMEHASH_SIZE;
+    buildNameHash();
+    if (length == 0) return 0;
+    while (nameHashTable[slot].name)
+    {
+        if (nameHashTable[slot].length == length && equalsIgnoringCase(nameHashTable[slot].name, name, length))
+            return &nameHashTable[slot];
+        slot = (slot + 1) % NAMEHASH_SIZE;
+    }
+    return 0;
+}
+
+/**
+ * @brief Scans a word (letters and '_' as scanExpression) and finds it as month or day name in one pass.
+ * @param source
+ * @param sourceEnd End of the source.
+ * @param ppEntry [output] Table entry or zero if the word is no month or day name.
+ * @return Position behind the word, 'source' if no word is found.
+ */
+static const char* scanName(const char* source, const char* sourceEnd, const stNameEntry** ppEntry)
+{
+    const char* position = source;
+    uint32_t hash = 2166136261u;
+    while (position<sourceEnd && (isupper((unsigned char)*position) || islower((unsigned char)*position) || *position=='_'))
+    {
+        hash = (hash ^ (uint32_t)tolower((unsigned char)*position)) * 16777619u;
+        position++;
+    }
+    *ppEntry = findName(source, (size_t)(position - source), hash);
+    return position;
+}
+
 /**
  * @brief dayNumber Finds the number of day within the week from a day string (full name or abbreviation).
+ * All languages are accepted, the comparison is not case sensitive.
  * @param dayName Day string.
  * @return Day nummber within the week [1..7] = Mon-Sun, 0 if unsuccessful.
  */
 unsigned int findDay(const char* dayName)
 {
-    int i,j;
-    for (i=0; i<enLanguageSize; i++)
-        for (j=1; j<=7; j++)
-        {
-            if (strcmp(dayName, dayNames[i][j])==0) return j;
-        }
-    return 0;
+    size_t length = strlen(dayName);
+    const stNameEntry* pEntry = findName(dayName, length, nameHash(dayName, length));
+    return pEntry ? pEntry->day : 0;
 }
 
 /**
  * @brief dayNumber Finds the number of month within the year from a month string (full name or abbreviation).
+ * All languages are accepted, the comparison is not case sensitive.
  * @param monthName Month string.
  * @return Number of month within the year [1..12] = Jan-Dec, 0 if unsuccessful.
  */
 unsigned int findMonth(const char* monthName)
 {
-    int i,j;
-    for (i=0; i<enLanguageSize; i++)
-        for (j=1; j<=12; j++)
-        {
-            if (strcmp(monthName, monthNames[i][j])==0) return j;
-        }
-    return 0;
+    size_t length = strlen(monthName);
+    const stNameEntry* pEntry = findName(monthName, length, nameHash(monthName, length));
+    return pEntry ? pEntry->month : 0;
 }
 
 /**
@@ -835,413 +1173,892 @@ stTimeZone LibOb_localTimeZone(int8_t* pDst)
     localtime_s(&lt, &lTime);
     time_t gtm = mktime(&gt);
     time_t ltm = mktime(&lt);
-    time_t zoneValue = (((ltm-gtm)+LibCpp_SECONDSPERHOUR/8) / (LibCpp_SECONDSPERHOUR/4));
-    zone.hours = (int8_t)(zoneValue>>2);
-    zone.minutes = ((uint8_t)(zoneValue&3))*15;
-    if (gt.tm_isdst>0) zone.hours -= 1;
-    if (lt.tm_isdst>0) zone.hours += 1;
+    time_t zoneValue = ltm-gtm;
+    zoneValue = (zoneValue + ((zoneValue<0) ? -LibCpp_SECONDSPERHOUR/8 : LibCpp_SECONDSPERHOUR/8)) / (LibCpp_SECONDSPERHOUR/4);    // rounded quarter hours
+    if (gt.tm_isdst>0) zoneValue -= 4;
+    if (lt.tm_isdst>0) zoneValue += 4;
+    zone.hours = (int8_t)(zoneValue/4);                                         // minutes carry the sign of the hours, e.g. -03:30
+    zone.minutes = (uint8_t)(((zoneValue<0) ? -zoneValue : zoneValue)%4)*15;
     if (pDst)
         *pDst = lt.tm_isdst;
     return zone;
 }
 
+/* Formatting helpers ----------------------------------------------------------------------- */
+
+static const char DIGITPAIRS[201] =                                             ///< Two digit strings "00" to "99" for number formatting
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/**
+ * @brief Writes an unsigned integer with at least 'width' digits (leading zeros).
+ * Two digits at once are taken from the table DIGITPAIRS.
+ * @param destination Buffer of at least 'width' and 10 characters. No termination is written.
+ * @param value
+ * @param width Minimum number of digits.
+ * @return Number of characters written.
+ */
+static size_t printUint(char* destination, unsigned int value, int width)
+{
+    char digits[16];
+    char* position = digits + 16;
+    while (value >= 100)
+    {
+        position -= 2;
+        memcpy(position, DIGITPAIRS + 2*(value % 100), 2);
+        value /= 100;
+    }
+    if (value >= 10)
+    {
+        position -= 2;
+        memcpy(position, DIGITPAIRS + 2*value, 2);
+    }
+    else
+        *--position = (char)('0' + value);
+    while (digits + 16 - position < width && position > digits)
+        *--position = '0';
+    memcpy(destination, position, (size_t)(digits + 16 - position));
+    return (size_t)(digits + 16 - position);
+}
+
+/**
+ * @brief Writes an integer with at least 'width' characters including the sign (as printf "%0*d" or "%+0*d").
+ * @param destination Buffer of at least 'width' and 11 characters. No termination is written.
+ * @param value
+ * @param width Minimum number of characters including the sign.
+ * @param plus If set, positive values are written with '+'.
+ * @return Number of characters written.
+ */
+static size_t printInt(char* destination, int value, int width, int plus)
+{
+    if (value < 0)
+    {
+        *destination = '-';
+        return 1 + printUint(destination + 1, 0u - (unsigned int)value, width - 1);
+    }
+    if (plus)
+    {
+        *destination = '+';
+        return 1 + printUint(destination + 1, (unsigned int)value, width - 1);
+    }
+    return printUint(destination, (unsigned int)value, width);
+}
+
+/**
+ * @brief Writes a zero terminated string without its termination.
+ * @param destination
+ * @param destinationEnd Pointer behind the last usable character.
+ * @param text
+ * @return Number of characters written, zero if 'text' does not fit.
+ */
+static size_t printString(char* destination, const char* destinationEnd, const char* text)
+{
+    size_t length = strlen(text);
+    if (length > (size_t)(destinationEnd - destination)) return 0;
+    memcpy(destination, text, length);
+    return length;
+}
+
+/**
+ * @brief Converts a single field of a calendrical time dataset (the conversion of one format symbol).
+ * Either a number is written to 'field' or '*pText' is set to a constant text (or to 'field' for created zone names).
+ * @param field Buffer of at least 32 characters. No termination is written for numbers.
+ * @param pText [output] Text of the field, zero if the field is a number written to 'field'.
+ * @param formatSymbol Format symbol, e.g. 'Y'.
+ * @param len Length modifier, 1 for '%1m', 2 for '%2m', 1 - 9 for '\%f', 0 otherwise.
+ * @param tp Calendrical time dataset
+ * @param pTimeZone Pointer to time zone hours and minutes supplementing the struct tp calendrical time dataset.
+ * @param pLanguage Pointer to a language choice information.
+ * @param nanoSeconds Fraction of the second supplementing 'tp' (\%f).
+ * @return Number of characters written to 'field', -1 if 'formatSymbol' is unknown.
+ */
+static int formatField(char* field, const char** pText, char formatSymbol, int len, const struct tm* tp, stTimeZone* pTimeZone, enum enLanguage* pLanguage, uint32_t nanoSeconds)
+{
+    size_t fieldLength = 0;
+    const char* text = 0;
+    switch (formatSymbol)
+    {
+    case 'Y':
+        if (tp->tm_year != INT_INVALID)
+            fieldLength = printInt(field, tp->tm_year+1900, 4, 0);
+        break;
+    case 'y':
+        if (tp->tm_year != INT_INVALID)
+            fieldLength = printInt(field, (tp->tm_year+1900)%100, 2, 0);
+        break;
+    case 'm':
+        if (tp->tm_mon != INT_INVALID)
+            fieldLength = printUint(field, (unsigned int)tp->tm_mon+1, (len!=1) ? 2 : 1);
+        break;
+    case 'b':
+        if (tp->tm_mon >= 0 && tp->tm_mon < 12)
+            text = monthNameAbbreviations[enLanguageIndex(pLanguage)][tp->tm_mon+1];
+        break;
+    case 'B':
+        if (tp->tm_mon >= 0 && tp->tm_mon < 12)
+            text = monthNames[enLanguageIndex(pLanguage)][tp->tm_mon+1];
+        break;
+    case 'e':
+    case 'd':
+        if (tp->tm_mday != INT_INVALID)
+            fieldLength = printUint(field, (unsigned int)tp->tm_mday, (len!=1 && formatSymbol!='e') ? 2 : 1);
+        break;
+    case 'H':
+        if (tp->tm_hour != INT_INVALID)
+            fieldLength = printUint(field, (unsigned int)tp->tm_hour, (len!=1) ? 2 : 1);
+        break;
+    case 'I':
+        if (tp->tm_hour != INT_INVALID)
+        {
+            unsigned int hour = (unsigned int)tp->tm_hour;
+            if (hour>12) hour = hour % 12;
+            fieldLength = printUint(field, hour, (len!=1) ? 2 : 1);
+        }
+        break;
+    case 'p':
+        if (tp->tm_hour != INT_INVALID)
+            text = (tp->tm_hour>=12) ? "PM" : "AM";
+        break;
+    case 'M':
+        if (tp->tm_min != INT_INVALID)
+            fieldLength = printUint(field, (unsigned int)tp->tm_min, (len!=1) ? 2 : 1);
+        break;
+    case 'S':
+        if (tp->tm_sec != INT_INVALID)
+            fieldLength = printUint(field, (unsigned int)tp->tm_sec, (len!=1) ? 2 : 1);
+        break;
+    case 'f':
+        if (nanoSeconds < 1000000000u)
+        {
+            int digits = len ? len : 6;
+            unsigned int value = nanoSeconds;
+            int n;
+            for (n=digits; n<9; n++) value /= 10;
+            fieldLength = printUint(field, value, digits);
+        }
+        break;
+    case 'U':
+        if (tp->tm_isdst >= -1 && tp->tm_isdst <= 1)
+            text = dstNames[tp->tm_isdst+1];
+        break;
+    case 'z':
+        if (pTimeZone)
+            if (pTimeZone->hours != INT8_INVALID)
+            {
+                fieldLength = printInt(field, pTimeZone->hours, 3, 1);
+                field[fieldLength++] = ':';
+                fieldLength += printUint(field+fieldLength, pTimeZone->minutes, 2);
+            }
+        break;
+    case 'Z':
+        if (pTimeZone)
+            if (pTimeZone->hours != INT8_INVALID)
+            {
+                text = findZoneName(*pTimeZone, (int8_t)tp->tm_isdst);
+                if (!text)
+                {
+                    createZoneName(field, 32, *pTimeZone, (int8_t)tp->tm_isdst);
+                    text = field;
+                }
+            }
+        break;
+    case 'a':
+    {
+        if (tp->tm_wday >= 0 && tp->tm_wday <= 6)
+            text = dayNameAbbreviations[enLanguageIndex(pLanguage)][tp->tm_wday ? tp->tm_wday : 7];
+        break;
+    }
+    case 'A':
+    {
+        if (tp->tm_wday >= 0 && tp->tm_wday <= 6)
+            text = dayNames[enLanguageIndex(pLanguage)][tp->tm_wday ? tp->tm_wday : 7];
+        break;
+    }
+    case 'j':
+        if (tp->tm_yday != INT_INVALID)
+            fieldLength = printUint(field, (unsigned int)tp->tm_yday+1, 1);
+        break;
+    case '%':
+        text = "%";
+        break;
+    default:
+        return -1;
+    }
+    *pText = text;
+    return (int)fieldLength;
+}
+
+/**
+ * @brief Copies the result of formatField() to the destination.
+ * @param pDestinationPosition Pointer to the write position, moved behind the written characters.
+ * @param destinationEnd Pointer behind the last usable character.
+ * @param field Number characters.
+ * @param fieldLength Number of characters within 'field'.
+ * @param text Text of the field or zero.
+ * @return 0 if the field does not fit, 1 otherwise.
+ */
+static int writeField(char** pDestinationPosition, const char* destinationEnd, const char* field, size_t fieldLength, const char* text)
+{
+    if (text)
+    {
+        fieldLength = printString(*pDestinationPosition, destinationEnd, text);
+        if (!fieldLength && *text) return 0;
+        *pDestinationPosition += fieldLength;
+    }
+    else if (fieldLength)
+    {
+        if (fieldLength > (size_t)(destinationEnd - *pDestinationPosition)) return 0;
+        memcpy(*pDestinationPosition, field, fieldLength);
+        *pDestinationPosition += fieldLength;
+    }
+    return 1;
+}
+
 /**
  * @brief Converts a calendrical time dataset to a character string.
+ * The numbers are written from a table of two digit strings, no printf function is called.
+ * The string is always terminated. In case a field does not fit into 'destination', the conversion
+ * stops before that field.\n
+ * If the same format is used many times, see LibOb_compileFormat().
+ * The fraction of the second (\%f) is written as zero, see LibOb_strftimeNano().
  * @param destination String buffer.
  * @param destinationSize String buffer size.
  * @param format Format string for string conversion.
  * @param tp Calendrical time dataset
  * @param pTimeZone Pointer to time zone hours and minutes supplementing the struct tp calendrical time dataset.
  * @param pLanguage Pointer to a language choice information.
- * @return Number of bytes written to destination
+ * @return Number of characters written to destination (without termination)
  */
 size_t LibOb_strftime(char* destination, size_t destinationSize, const char* format, const struct tm* tp, stTimeZone* pTimeZone, enum enLanguage* pLanguage)
+{
+    return LibOb_strftimeNano(destination, destinationSize, format, tp, pTimeZone, pLanguage, 0);
+}
+
+/**
+ * @brief Converts a calendrical time dataset with a fraction of the second to a character string.
+ * Same as LibOb_strftime(), 'struct tm' has no entry for the fraction of the second written by \%f.
+ * @param destination String buffer.
+ * @param destinationSize String buffer size.
+ * @param format Format string for string conversion.
+ * @param tp Calendrical time dataset
+ * @param pTimeZone Pointer to time zone hours and minutes supplementing the struct tp calendrical time dataset.
+ * @param pLanguage Pointer to a language choice information.
+ * @param nanoSeconds Nano seconds after the second of 'tp' (0 - 999999999), UINT32_INVALID if unknown.
+ * @return Number of characters written to destination (without termination)
+ */
+size_t LibOb_strftimeNano(char* destination, size_t destinationSize, const char* format, const struct tm* tp, stTimeZone* pTimeZone, enum enLanguage* pLanguage, uint32_t nanoSeconds)
 {
     const char* formatPosition = format;
     char* destinationPosition = destination;
-    char* lastDestionationPosition = destination+destinationSize-2;
-    const char* stdFormat = "%Y-%m-%d#%H:%M:%S#%U#%z";
+    const char* destinationEnd = destination+destinationSize-1;    // reserved for termination
+    char field[32];
+    if (!destination || destinationSize == 0) return 0;
     if (!format)
-        formatPosition = stdFormat;
+        formatPosition = LibOb_DEFAULTFORMAT;
     if (*formatPosition==0)
-        formatPosition = stdFormat;
+        formatPosition = LibOb_DEFAULTFORMAT;
     *destination = 0;
     if (!tp) return 0;
-    while(*formatPosition && destinationPosition<lastDestionationPosition)
+    while(*formatPosition && destinationPosition<destinationEnd)
     {
-        formatPosition = strcpyfmt(formatPosition, &destinationPosition, destination+destinationSize-1);
+        formatPosition = strcpyfmt(formatPosition, &destinationPosition, destination+destinationSize);
         if (*formatPosition)
         {
             int len = 0;
+            int fieldLength;
+            const char* text = 0;
             if (*formatPosition=='1') {len = 1; formatPosition++;}
             if (*formatPosition=='2') {len = 2; formatPosition++;}
-            char formatSymbol = *formatPosition;
-            switch (formatSymbol)
-            {
-            case 'Y':
-                if (tp->tm_year != INT_INVALID)
-                    destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%04d", (int)tp->tm_year+1900);
-                break;
-            case 'y':
-                if (tp->tm_year != INT_INVALID)
-                    destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%02d", (int)(tp->tm_year+1900)%100);
-                break;
-            case 'm':
-                if (tp->tm_mon != INT_INVALID)
-                {
-                    if (len!=1)
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%02u", (unsigned int)tp->tm_mon+1);
-                    else
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%u", (unsigned int)tp->tm_mon+1);
-                }
-                break;
-            case 'b':
-                if (tp->tm_mon != INT_INVALID)
-                    destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%s", dayNameAbbreviations[enLanguageIndex(pLanguage)][tp->tm_mon+1]);
-                break;
-            case 'B':
-                if (tp->tm_mon != INT_INVALID)
-                    destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%s", dayNames[enLanguageIndex(pLanguage)][tp->tm_mon+1]);
-                break;
-            case 'e':
-            case 'd':
-                if (tp->tm_mday != INT_INVALID)
-                {
-                    if (len!=1 && formatSymbol!='e')
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%02u", (unsigned int)tp->tm_mday);
-                    else
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%u", (unsigned int)tp->tm_mday);
-                }
-                break;
-            case 'H':
-                if (tp->tm_hour != INT_INVALID)
-                {
-                    if (len!=1)
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%02u", (unsigned int)tp->tm_hour);
-                    else
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%u", (unsigned int)tp->tm_hour);
-                }
+            if (*formatPosition>='3' && *formatPosition<='9') {len = *formatPosition - '0'; formatPosition++;}
+            fieldLength = formatField(field, &text, *formatPosition, len, tp, pTimeZone, pLanguage, nanoSeconds);
+            if (fieldLength < 0)
+                formatPosition--;
+            else if (!writeField(&destinationPosition, destinationEnd, field, (size_t)fieldLength, text))
                 break;
-            case 'I':
+            if (*formatPosition) formatPosition++;
+        }
+    }
+    *destinationPosition = 0;
+    return (size_t)(destinationPosition - destination);
+}
+
+/**
+ * @brief Converts a string containing calendrical time data to a numeric calendrical time data set.
+ * If the same format is used many times, see LibOb_compileFormat().
+ * @param source Input character string.
+ * @param format Format string. If set to zero an automatic scan is executed.
+ * @param tp Output of numeric data set.
+ * @param pTimeZone Pointer to time zone data supplementing 'tp'.
+ * @return Pointer to the first character of source that is not being consumed by the format string.
+ */
+const char* LibOb_strptime(const char* source, const char* format, struct tm* tp, stTimeZone* pTimeZone)
+{
+    return LibOb_strnptime(source, strlen(source), format, tp, pTimeZone);
+}
+
+/**
+ * @brief Scans a single field of a calendrical time string (the conversion of one format symbol).
+ * @param formatSymbol Format symbol, e.g. 'Y'.
+ * @param sourcePosition Position within the source.
+ * @param lastSourcePosition End of the source.
+ * @param tp Output of numeric data set.
+ * @param pTimeZone Pointer to time zone data supplementing 'tp'. May be zero.
+ * @param pNanoSeconds Fraction of the second supplementing 'tp' (\%f). May be zero.
+ * @param pPMdetected PM state shared by the fields of one string.
+ * @return Position behind the field (unchanged if the field is not found), zero if 'formatSymbol' is unknown.
+ */
+static const char* scanField(char formatSymbol, const char* sourcePosition, const char* lastSourcePosition, struct tm* tp, stTimeZone* pTimeZone, uint32_t* pNanoSeconds, int* pPMdetected)
+{
+    switch (formatSymbol)
+    {
+    case 'Y':
+    {
+        int year = 0;
+        const char* scanResult =  scanInt(sourcePosition, lastSourcePosition, &year, 0, 0, 0);
+        if (scanResult)
+        {
+            tp->tm_year = year - 1900;
+            sourcePosition = scanResult;
+        }
+        break;
+    }
+    case 'y':
+    {
+        int year = 0;
+        const char* next =  scanInt(sourcePosition, lastSourcePosition, &year, 0, 0, 0);
+        if (next)
+        {
+            if (year>=0 && year<100)
             {
-                if (tp->tm_hour != INT_INVALID)
-                {
-                    unsigned int hour = (unsigned int)tp->tm_hour;
-                    if (hour>12) hour = hour % 12;
-                    if (len!=1)
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%02u", hour);
-                    else
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%u", hour);
-                }
-                break;
+                year += 2000;
+                if (year>2068) year -= 100;
             }
-            case 'p':
-                if (tp->tm_hour != INT_INVALID)
-                {
-                    if (tp->tm_hour>=12)
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%s", "PM");
-                    else
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%s", "AM");
-                }
-                break;
-            case 'M':
-                if (tp->tm_min != INT_INVALID)
-                {
-                    if (len!=1)
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%02u", (unsigned int)tp->tm_min);
-                    else
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%u", (unsigned int)tp->tm_min);
-                }
-                break;
-            case 'S':
-                if (tp->tm_sec != INT_INVALID)
-                {
-                    if (len!=1)
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%02u", (unsigned int)tp->tm_sec);
-                    else
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%u", (unsigned int)tp->tm_sec);
-                }
-                break;
-            case 'U':
-                if (tp->tm_isdst != INT_INVALID)
-                {
-                    if (tp->tm_isdst == -1)
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%s", "UTC");
-                    if (tp->tm_isdst == 0)
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%s", "STD");
-                    if (tp->tm_isdst == 1)
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%s", "DST");
-                }
-                break;
-            case 'z':
-                if (pTimeZone)
-                    if (pTimeZone->hours != INT8_INVALID)
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%+03d:%02u", (int)(*pTimeZone).hours, (unsigned int)(*pTimeZone).minutes);
-                break;
-            case 'Z':
-                if (pTimeZone)
-                    if (pTimeZone->hours != INT8_INVALID)
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%s", findZoneName(*pTimeZone, tp->tm_isdst));
-                break;
-            case 'a':
+            tp->tm_year = year - 1900;
+            sourcePosition = next;
+        }
+        break;
+    }
+    case 'm':
+    {
+        unsigned int month = 0;
+        const char* next =  scanUint(sourcePosition, lastSourcePosition, &month, 0, 0, 1);
+        if (next)
+        {
+            tp->tm_mon = month - 1;
+            sourcePosition = next;
+        }
+        break;
+    }
+    case 'b':
+    case 'B':
+    {
+        const stNameEntry* pEntry;
+        if (sourcePosition >= lastSourcePosition) break;
+        sourcePosition = scanName(sourcePosition, lastSourcePosition, &pEntry);
+        tp->tm_mon = (pEntry && pEntry->month) ? pEntry->month - 1 : INT_INVALID;
+        break;
+    }
+    case 'e':
+    case 'd':
+    {
+        unsigned int day = 0;
+        const char* next =  scanUint(sourcePosition, lastSourcePosition, &day, 0, 0, 1);
+        if (next)
+        {
+            tp->tm_mday = day;
+            sourcePosition = next;
+        }
+        break;
+    }
+    case 'H':
+    {
+        unsigned int hour = 0;
+        const char* next =  scanUint(sourcePosition, lastSourcePosition, &hour, 0, 0, 0);
+        if (next)
+        {
+            tp->tm_hour = hour;
+            sourcePosition = next;
+        }
+        break;
+    }
+    case 'I':
+    {
+        unsigned int hour = 0;
+        const char* next =  scanUint(sourcePosition, lastSourcePosition, &hour, 0, 0, 0);
+        if (next)
+        {
+            if (*pPMdetected)
             {
-                if (tp->tm_wday != INT_INVALID)
-                {
-                    unsigned int index = tp->tm_wday;
-                    if (index>0 && index<=6)
-                    {
-                        if (index==0) index = 7;
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%s", dayNameAbbreviations[enLanguageIndex(pLanguage)][index]);
-                    }
-                }
-                break;
+                hour += 12;
+                if (hour==24) hour=0;
             }
-            case 'A':
+            else
             {
-                if (tp->tm_wday != INT_INVALID)
-                {
-                    unsigned int index = tp->tm_wday;
-                    if (index>0 && index<=6)
-                    {
-                        if (index==0) index = 7;
-                        destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%s", dayNames[enLanguageIndex(pLanguage)][index]);
-                    }
-                }
-                break;
+                if (hour>12)
+                    *pPMdetected = 1;
             }
-            case 'j':
-                if (tp->tm_yday != INT_INVALID)
-                    destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%u", tp->tm_yday+1);
-                break;
-            case '%':
-                destinationPosition += sprintf_s(destinationPosition, lastDestionationPosition-destinationPosition, "%s", "%");
-                break;
-            default:
-                formatPosition--;
+            tp->tm_hour = hour;
+            sourcePosition = next;
+        }
+        break;
+    }
+    case 'p':
+        if (lastSourcePosition-sourcePosition >= 2 && *sourcePosition == 'P' && *(sourcePosition+1) == 'M')
+        {
+            *pPMdetected = 1;
+            if (tp->tm_hour != INT_INVALID && tp->tm_hour != 12)
+                tp->tm_hour += 12;
+            sourcePosition += 2;
+        }
+        break;
+    case 'M':
+    {
+        unsigned int minute = 0;
+        const char* next =  scanUint(sourcePosition, lastSourcePosition, &minute, 0, 0, 0);
+        if (next)
+        {
+            tp->tm_min = minute;
+            sourcePosition = next;
+        }
+        break;
+    }
+    case 'S':
+    {
+        unsigned int second = 0;
+        int negative = 0;
+        const char* next =  scanDigits(sourcePosition, lastSourcePosition, &negative, &second);     // a fraction may follow
+        if (next && !negative)
+        {
+            tp->tm_sec = second;
+            sourcePosition = next;
+        }
+        break;
+    }
+    case 'f':
+    {
+        unsigned int fraction = 0;
+        unsigned int scale = 1000000000u;
+        const char* next = sourcePosition;
+        while (next < lastSourcePosition && (unsigned char)(*next - '0') < 10)
+        {
+            if (scale > 1)
+            {
+                scale /= 10;
+                fraction += (unsigned int)(*next - '0') * scale;
             }
-            if (*formatPosition) formatPosition++;
+            next++;
         }
+        if (next != sourcePosition)
+        {
+            if (pNanoSeconds) *pNanoSeconds = fraction;
+            sourcePosition = next;
+        }
+        break;
     }
-    *destinationPosition = 0;
-    return 0;
+    case 'U':
+    {
+        int8_t dst = scanDst(sourcePosition, lastSourcePosition, 1);
+        if (dst!=(int8_t)0x80)
+        {
+            sourcePosition += 3;
+            tp->tm_isdst = dst;
+        }
+        break;
+    }
+    case 'z':
+    {
+        stTimeZone result = stTimeZone_Ini;
+        const char* scanResult = scanTimeZone(sourcePosition, lastSourcePosition, &result);
+        if (scanResult)
+        {
+            sourcePosition = scanResult;
+            if (pTimeZone) *pTimeZone = result;
+            if (tp->tm_isdst == INT_INVALID) tp->tm_isdst = -1;
+        }
+        break;
+    }
+    case 'Z':
+    {
+        stZoneAbbreviation result;
+        const char* scanResult = scanZone(sourcePosition, lastSourcePosition, &result);
+        if (scanResult)
+        {
+            sourcePosition = scanResult;
+            if (pTimeZone) *pTimeZone = result.zone;
+            tp->tm_isdst = result.dst;
+        }
+        break;
+    }
+    case 'a':
+    case 'A':
+    {
+        const stNameEntry* pEntry;
+        const char* next =  scanName(sourcePosition, lastSourcePosition, &pEntry);
+        if (pEntry && pEntry->day)
+        {
+            tp->tm_wday = pEntry->day % 7;
+            sourcePosition = next;
+        }
+        break;
+    }
+    case 'j':
+    case '%':
+        break;
+    default:
+        return 0;
+    }
+    return sourcePosition;
 }
 
 /**
- * @brief Converts a string containing calendrical time data to a numeric calendrical time data set.
- * @param source Input character string.
- * @param format Format string. If set to zero an automatic scan is executed.
+ * @brief Converts 'sourceLength' characters containing calendrical time data to a numeric calendrical time data set.
+ * Same as LibOb_strptime, but the source does not need to be zero terminated. No character at or behind
+ * source+sourceLength is read. This allows to parse time stamps within larger buffers (e.g. memory mapped log files)
+ * without copying them.
+ * @param source Input characters.
+ * @param sourceLength Number of characters of 'source' to be scanned at most.
+ * @param format Format string (zero terminated). If set to zero an automatic scan is executed.
  * @param tp Output of numeric data set.
  * @param pTimeZone Pointer to time zone data supplementing 'tp'.
  * @return Pointer to the first character of source that is not being consumed by the format string.
  */
-const char* LibOb_strptime(const char* source, const char* format, struct tm* tp, stTimeZone* pTimeZone)
+const char* LibOb_strnptime(const char* source, size_t sourceLength, const char* format, struct tm* tp, stTimeZone* pTimeZone)
+{
+    return LibOb_strnptimeNano(source, sourceLength, format, tp, pTimeZone, 0);
+}
+
+/**
+ * @brief Converts 'sourceLength' characters containing calendrical time data with a fraction of the second to a numeric calendrical time data set.
+ * Same as LibOb_strnptime(), 'struct tm' has no entry for the fraction of the second read by \%f.
+ * @param source Input characters.
+ * @param sourceLength Number of characters of 'source' to be scanned at most.
+ * @param format Format string (zero terminated). If set to zero an automatic scan is executed (without fraction).
+ * @param tp Output of numeric data set.
+ * @param pTimeZone Pointer to time zone data supplementing 'tp'.
+ * @param pNanoSeconds Output of the nano seconds after the second of 'tp', 0 if the source has no fraction. May be zero.
+ * @return Pointer to the first character of source that is not being consumed by the format string.
+ */
+const char* LibOb_strnptimeNano(const char* source, size_t sourceLength, const char* format, struct tm* tp, stTimeZone* pTimeZone, uint32_t* pNanoSeconds)
 {
     const char* formatPosition = format;
     const char* sourcePosition = source;
-    const char* lastSourcePosition = source+strlen(source);
+    const char* lastSourcePosition = source+sourceLength;
     int PMdetected = 0;
     if (!tp) return source;
     *tp = tm_Invalid;
     if (pTimeZone)
         *pTimeZone = stTimeZone_Invalid;
+    if (pNanoSeconds)
+        *pNanoSeconds = 0;
     if (!format)
-        return scanCalendar(source, tp, pTimeZone);
+        return scanCalendar(source, lastSourcePosition, tp, pTimeZone);
     if (*format==0)
-        return scanCalendar(source, tp, pTimeZone);
+        return scanCalendar(source, lastSourcePosition, tp, pTimeZone);
 
     while(*formatPosition && sourcePosition<lastSourcePosition)
     {
-        formatPosition = strchkfmt(formatPosition, &sourcePosition);
+        formatPosition = strchkfmt(formatPosition, &sourcePosition, lastSourcePosition);
+        if (!formatPosition) break;
         if (*formatPosition)
         {
+            const char* next;
             if (*formatPosition=='1') formatPosition++;
             if (*formatPosition=='2') formatPosition++;
-            char formatSymbol = *formatPosition;
-            switch (formatSymbol)
+            if (*formatPosition>='3' && *formatPosition<='9') formatPosition++;
+            next = scanField(*formatPosition, sourcePosition, lastSourcePosition, tp, pTimeZone, pNanoSeconds, &PMdetected);
+            if (next)
+                sourcePosition = next;
+            else
+                formatPosition--;
+            if (*formatPosition) formatPosition++;
+        }
+    }
+    return sourcePosition;
+}
+
+/* Compiled formats ------------------------------------------------------------------------ */
+
+/**
+ * @brief Appends a literal run to a format program, joining it with a directly preceding run.
+ * @param pProgram
+ * @param literal First character of the run.
+ * @param length Number of characters.
+ * @return 0 if the program is full, 1 otherwise.
+ */
+static int appendLiteral(stFormatProgram* pProgram, const char* literal, size_t length)
+{
+    stFormatInstruction* pLast = pProgram->count ? &pProgram->instructions[pProgram->count-1] : 0;
+    if (length == 0) return 1;
+    if (pProgram->literalCount + length > LibOb_FORMATLITERALS) return 0;
+    memcpy(pProgram->literals + pProgram->literalCount, literal, length);
+    if (pLast && pLast->type == LibOb_FORMAT_LITERAL && pLast->offset + pLast->width == pProgram->literalCount && pLast->width + length <= 255)
+        pLast->width += (uint8_t)length;
+    else
+    {
+        stFormatInstruction instruction = {LibOb_FORMAT_LITERAL, 0, 0, (uint8_t)length, pProgram->literalCount, 0};
+        if (pProgram->count >= LibOb_FORMATINSTRUCTIONS) return 0;
+        pProgram->instructions[pProgram->count++] = instruction;
+    }
+    pProgram->literalCount += (uint16_t)length;
+    return 1;
+}
+
+/**
+ * @brief Turns a format instruction into a number instruction of a struct tm entry.
+ * @param pInstruction Instruction with the modifier already set.
+ * @param offset Offset of the int entry within struct tm.
+ * @param addend Value added to the entry for formatting (e.g. 1900 for tm_year).
+ * @param width Fixed width, 0 to use the width of the modifier (1 for '%1', 2 otherwise).
+ */
+static void setNumber(stFormatInstruction* pInstruction, size_t offset, int16_t addend, uint8_t width)
+{
+    pInstruction->type = LibOb_FORMAT_NUMBER;
+    pInstruction->offset = (uint16_t)offset;
+    pInstruction->addend = addend;
+    pInstruction->width = width ? width : ((pInstruction->modifier == 1) ? 1 : 2);
+}
+
+/**
+ * @brief Compiles a format string into a format program for LibOb_strftimeProgram() and LibOb_strnptimeProgram().
+ * The format string is interpreted once: the literal text between the format symbols is stored as runs of
+ * characters, the numeric fields of struct tm ('%Y', '%m', '%d', '%e', '%H', '%M', '%S', '%j') are stored with their
+ * entry and fixed width. All other symbols are executed like LibOb_strftime() and LibOb_strptime() do.
+ * The results of the programs are identical to the interpreted functions. As the programs read and write
+ * 'struct tm' only, the fraction of the second (\%f) is read over and written as zero.
+ * \code
+ * stFormatProgram program;
+ * LibOb_compileFormat(&program, "%Y-%m-%d %H:%M:%S");     // once
+ * LibOb_strftimeProgram(buffer, sizeof(buffer), &program, &tm, &zone, 0);   // many times
+ * \endcode
+ * @param pProgram Resulting program.
+ * @param format Format string (see \ref TIME_FORMATTING). Zero or an empty string compiles the default format LibOb_DEFAULTFORMAT.
+ * @return 1 on success, 0 if the format exceeds LibOb_FORMATINSTRUCTIONS instructions or LibOb_FORMATLITERALS literal characters.
+ */
+int LibOb_compileFormat(stFormatProgram* pProgram, const char* format)
+{
+    const char* formatPosition = format;
+    if (!pProgram) return 0;
+    pProgram->count = 0;
+    pProgram->literalCount = 0;
+    if (!format || *format==0)
+        formatPosition = LibOb_DEFAULTFORMAT;
+    while (*formatPosition)
+    {
+        const char* literal = formatPosition;
+        while (*formatPosition && *formatPosition!='%') formatPosition++;
+        if (!appendLiteral(pProgram, literal, (size_t)(formatPosition - literal))) return 0;
+        if (*formatPosition=='%')
+        {
+            stFormatInstruction instruction = {LibOb_FORMAT_FIELD, 0, 0, 0, 0, 0};
+            formatPosition++;
+            if (*formatPosition=='1') {instruction.modifier = 1; formatPosition++;}
+            if (*formatPosition=='2') {instruction.modifier = 2; formatPosition++;}
+            if (*formatPosition>='3' && *formatPosition<='9') {instruction.modifier = (uint8_t)(*formatPosition - '0'); formatPosition++;}
+            instruction.symbol = *formatPosition;
+            switch (instruction.symbol)
             {
+            case 0:
+                continue;
             case 'Y':
-            {
-                int year = 0;
-                const char* scanResult =  scanInt(sourcePosition, &year, 0, 0, 0);
-                if (scanResult)
-                {
-                    tp->tm_year = year - 1900;
-                    sourcePosition = scanResult;
-                }
+                setNumber(&instruction, offsetof(struct tm, tm_year), 1900, 4);
                 break;
-            }
-            case 'y':
-            {
-                int year = 0;
-                const char* next =  scanInt(sourcePosition, &year, 0, 0, 0);
-                if (next)
-                {
-                    if (year>=0 && year<100)
-                    {
-                        year += 2000;
-                        if (year>2068) year -= 100;
-                    }
-                    tp->tm_year = year - 1900;
-                    sourcePosition = next;
-                }
-                break;
-            }
             case 'm':
-            {
-                unsigned int month = 0;
-                const char* next =  scanUint(sourcePosition, &month, 0, 0, 1);
-                if (next)
-                {
-                    tp->tm_mon = month - 1;
-                    sourcePosition = next;
-                }
+                setNumber(&instruction, offsetof(struct tm, tm_mon), 1, 0);
                 break;
-            }
-            case 'b':
-            case 'B':
-            {
-                char buffer[64] = "";
-                int month = INT_INVALID;
-                const char* next =  scanExpression(sourcePosition, buffer, 64, 0, 0);
-                if (next)
-                {
-                    month = findMonth(buffer);
-                    if (month == 0) month = INT_INVALID;
-                    tp->tm_mon = month - 1;
-                    sourcePosition = next;
-                }
+            case 'd':
+                setNumber(&instruction, offsetof(struct tm, tm_mday), 0, 0);
                 break;
-            }
             case 'e':
-            case 'd':
-            {
-                unsigned int day = 0;
-                const char* next =  scanUint(sourcePosition, &day, 0, 0, 1);
-                if (next)
-                {
-                    tp->tm_mday = day;
-                    sourcePosition = next;
-                }
+                setNumber(&instruction, offsetof(struct tm, tm_mday), 0, 1);
                 break;
-            }
             case 'H':
-            {
-                unsigned int hour = 0;
-                const char* next =  scanUint(sourcePosition, &hour, 0, 0, 0);
-                if (next)
-                {
-                    tp->tm_hour = hour;
-                    sourcePosition = next;
-                }
+                setNumber(&instruction, offsetof(struct tm, tm_hour), 0, 0);
                 break;
-            }
-            case 'I':
-            {
-                unsigned int hour = 0;
-                const char* next =  scanUint(sourcePosition, &hour, 0, 0, 0);
-                if (next)
-                {
-                    if (PMdetected)
-                    {
-                        hour += 12;
-                        if (hour==24) hour=0;
-                    }
-                    else
-                    {
-                        if (hour>12)
-                            PMdetected = 1;
-                    }
-                    tp->tm_hour = hour;
-                    sourcePosition = next;
-                }
+            case 'M':
+                setNumber(&instruction, offsetof(struct tm, tm_min), 0, 0);
                 break;
-            }
-            case 'p':
-                if (*sourcePosition == 'P' && *(sourcePosition+1) == 'M')
-                {
-                    PMdetected = 1;
-                    if (tp->tm_hour != INT_INVALID && tp->tm_hour != 12)
-                        tp->tm_hour += 12;
-                    sourcePosition += 2;
-                }
+            case 'S':
+                setNumber(&instruction, offsetof(struct tm, tm_sec), 0, 0);
                 break;
-            case 'M':
-            {
-                unsigned int minute = 0;
-                const char* next =  scanUint(sourcePosition, &minute, 0, 0, 0);
-                if (next)
-                {
-                    tp->tm_min = minute;
-                    sourcePosition = next;
-                }
+            case 'j':
+                setNumber(&instruction, offsetof(struct tm, tm_yday), 1, 1);
+                break;
+            case 'y': case 'b': case 'B': case 'I': case 'p': case 'U': case 'z': case 'Z': case 'a': case 'A': case 'f': case '%':
                 break;
+            default:                // unknown symbols are literal text, the '%' is dropped
+                continue;
             }
-            case 'S':
+            if (pProgram->count >= LibOb_FORMATINSTRUCTIONS) return 0;
+            pProgram->instructions[pProgram->count++] = instruction;
+            formatPosition++;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Converts a calendrical time dataset to a character string using a compiled format.
+ * Same as LibOb_strftime() with the format given to LibOb_compileFormat().
+ * @param destination String buffer.
+ * @param destinationSize String buffer size.
+ * @param pProgram Compiled format, see LibOb_compileFormat().
+ * @param tp Calendrical time dataset
+ * @param pTimeZone Pointer to time zone hours and minutes supplementing the struct tp calendrical time dataset.
+ * @param pLanguage Pointer to a language choice information.
+ * @return Number of characters written to destination (without termination)
+ */
+size_t LibOb_strftimeProgram(char* destination, size_t destinationSize, const stFormatProgram* pProgram, const struct tm* tp, stTimeZone* pTimeZone, enum enLanguage* pLanguage)
+{
+    char* destinationPosition = destination;
+    const char* destinationEnd = destination+destinationSize-1;    // reserved for termination
+    char field[32];
+    int n;
+    if (!destination || destinationSize == 0) return 0;
+    *destination = 0;
+    if (!tp || !pProgram) return 0;
+    for (n=0; n<pProgram->count && destinationPosition<destinationEnd; n++)
+    {
+        const stFormatInstruction* pInstruction = &pProgram->instructions[n];
+        if (pInstruction->type == LibOb_FORMAT_LITERAL)
+        {
+            size_t length = pInstruction->width;
+            if (length > (size_t)(destinationEnd - destinationPosition))
+                length = (size_t)(destinationEnd - destinationPosition);
+            memcpy(destinationPosition, pProgram->literals + pInstruction->offset, length);
+            destinationPosition += length;
+        }
+        else if (pInstruction->type == LibOb_FORMAT_NUMBER)
+        {
+            int value = *(const int*)((const char*)tp + pInstruction->offset);
+            size_t fieldLength;
+            if (value == INT_INVALID) continue;
+            value += pInstruction->addend;
+            if (pInstruction->width == 2 && (unsigned int)value < 100)
             {
-                unsigned int second = 0;
-                const char* next =  scanUint(sourcePosition, &second, 0, 0, 0);
-                if (next)
-                {
-                    tp->tm_sec = second;
-                    sourcePosition = next;
-                }
-                break;
+                if (destinationEnd - destinationPosition < 2) break;
+                memcpy(destinationPosition, DIGITPAIRS + 2*value, 2);
+                destinationPosition += 2;
+                continue;
             }
-            case 'U':
+            if (pInstruction->width == 4 && (unsigned int)value < 10000)
             {
-                int8_t dst = scanDst(source, 1);
-                if (dst!=(int8_t)0x80)
-                {
-                    sourcePosition += 3;
-                    tp->tm_isdst = dst;
-                }
-                break;
+                if (destinationEnd - destinationPosition < 4) break;
+                memcpy(destinationPosition, DIGITPAIRS + 2*(value / 100), 2);
+                memcpy(destinationPosition + 2, DIGITPAIRS + 2*(value % 100), 2);
+                destinationPosition += 4;
+                continue;
             }
-            case 'z':
+            if (pInstruction->symbol == 'Y')
+                fieldLength = printInt(field, value, pInstruction->width, 0);
+            else
+                fieldLength = printUint(field, (unsigned int)value, pInstruction->width);
+            if (!writeField(&destinationPosition, destinationEnd, field, fieldLength, 0))
+                break;
+        }
+        else
+        {
+            const char* text = 0;
+            int fieldLength = formatField(field, &text, pInstruction->symbol, pInstruction->modifier, tp, pTimeZone, pLanguage, 0);
+            if (!writeField(&destinationPosition, destinationEnd, field, (size_t)fieldLength, text))
+                break;
+        }
+    }
+    *destinationPosition = 0;
+    return (size_t)(destinationPosition - destination);
+}
+
+/**
+ * @brief Converts 'sourceLength' characters containing calendrical time data to a numeric calendrical time data set using a compiled format.
+ * Same as LibOb_strnptime() with the format given to LibOb_compileFormat().
+ * @param source Input characters.
+ * @param sourceLength Number of characters of 'source' to be scanned at most.
+ * @param pProgram Compiled format, see LibOb_compileFormat().
+ * @param tp Output of numeric data set.
+ * @param pTimeZone Pointer to time zone data supplementing 'tp'.
+ * @return Pointer to the first character of source that is not being consumed by the format.
+ */
+const char* LibOb_strnptimeProgram(const char* source, size_t sourceLength, const stFormatProgram* pProgram, struct tm* tp, stTimeZone* pTimeZone)
+{
+    const char* sourcePosition = source;
+    const char* lastSourcePosition = source+sourceLength;
+    int PMdetected = 0;
+    int n;
+    if (!tp || !pProgram) return source;
+    *tp = tm_Invalid;
+    if (pTimeZone)
+        *pTimeZone = stTimeZone_Invalid;
+    for (n=0; n<pProgram->count && sourcePosition<lastSourcePosition; n++)
+    {
+        const stFormatInstruction* pInstruction = &pProgram->instructions[n];
+        if (pInstruction->type == LibOb_FORMAT_LITERAL)
+        {
+            const char* literal = pProgram->literals + pInstruction->offset;
+            size_t length = pInstruction->width;
+            if (length > (size_t)(lastSourcePosition - sourcePosition))
+                length = (size_t)(lastSourcePosition - sourcePosition);
+            if (memcmp(sourcePosition, literal, length) != 0)
             {
-                stTimeZone result = stTimeZone_Ini;
-                const char* scanResult = scanTimeZone(sourcePosition, &result);
-                if (scanResult)
-                {
-                    sourcePosition = scanResult;
-                    if (pTimeZone) *pTimeZone = result;
-                }
+                while (*sourcePosition == *literal) {sourcePosition++; literal++;}
                 break;
             }
-            case 'Z':
-            {
-                stZoneAbbreviation result;
-                const char* scanResult = scanZone(sourcePosition, &result);
-                if (scanResult)
+            sourcePosition += length;
+        }
+        else
+        {
+            if (pInstruction->type == LibOb_FORMAT_NUMBER && pInstruction->symbol != 'j' && pInstruction->width >= 2
+                && lastSourcePosition - sourcePosition >= pInstruction->width)
+            {   // fixed number of digits not followed by a digit or a character indicating a float
+                const char* digit = sourcePosition;
+                const char* digitEnd = sourcePosition + pInstruction->width;
+                int value = 0;
+                while (digit < digitEnd && (unsigned char)(*digit - '0') < 10)
                 {
-                    sourcePosition = scanResult;
-                    if (pTimeZone) *pTimeZone = result.zone;
+                    value = value*10 + (*digit - '0');
+                    digit++;
+                }
+                if (digit == digitEnd && (digit == lastSourcePosition
+                    || ((unsigned char)(*digit - '0') >= 10 && *digit != '.' && *digit != ',' && *digit != 'e' && *digit != 'E')))
+                {
+                    *(int*)((char*)tp + pInstruction->offset) = value - pInstruction->addend;
+                    sourcePosition = digitEnd;
+                    continue;
                 }
-                break;
-            }
-            case 'a':
-            case 'A':
-            case 'j':
-            case '%':
-                break;
-            default:
-                formatPosition--;
             }
-            if (*formatPosition) formatPosition++;
+            sourcePosition = scanField(pInstruction->symbol, sourcePosition, lastSourcePosition, tp, pTimeZone, 0, &PMdetected);
         }
     }
     return sourcePosition;
 }
 
 /**
- * @brief Scans a calendar string and converts it to calendar data 'struct tm' and 'stTimeZone' without need of a format string.
- * The string will be completely scanned until 0 is reached.
+ * @brief Records a field assigned by scanCalendarTokens().
+ * @param pTokens Token list, may be zero.
+ * @param begin
+ * @param end
+ * @param symbol
+ */
+static void addToken(stCalendarTokens* pTokens, const char* begin, const char* end, char symbol)
+{
+    if (!pTokens) return;
+    if (pTokens->count < CALENDARTOKENS)
+    {
+        stCalendarToken token = {begin, end, symbol};
+        pTokens->tokens[pTokens->count] = token;
+    }
+    pTokens->count++;
+}
+
+/**
+ * @brief scanCalendar() additionally recording which characters have been assigned to which field.
  * @param source String to be scanned.
+ * @param sourceEnd End of the string, zero for a zero terminated string.
  * @param tp Resulting calendar data.
  * @param pTimeZone Resulting time zone. Might be set to zero.
+ * @param pTokens Resulting fields, may be zero.
  * @return
  */
-const char* scanCalendar(const char* source, struct tm* tp, stTimeZone* pTimeZone)
+static const char* scanCalendarTokens(const char* source, const char* sourceEnd, struct tm* tp, stTimeZone* pTimeZone, stCalendarTokens* pTokens)
 {
     char buffer[64];
     const char* scanPos = source;
@@ -1249,39 +2066,45 @@ const char* scanCalendar(const char* source, struct tm* tp, stTimeZone* pTimeZon
     int type = 0;
     int cnt = 0;
 
+    if (pTokens) pTokens->count = 0;
     if (!tp) return source;
     *tp = tm_Invalid;
     if (pTimeZone)
         *pTimeZone = stTimeZone_Invalid;
 
-    scanPos = scipNonLetters(scanPos, &type);
-    while (*scanPos && cnt++<100)
+    sourceEnd = endOfSource(source, sourceEnd);
+    scanPos = scipNonLetters(scanPos, sourceEnd, &type);
+    while (scanPos<sourceEnd && cnt++<100)
     {
         if (type == 2)
         {   // string
-            resultPos = scanExpression(scanPos, buffer, 64, 0, 0);
+            resultPos = scanExpression(scanPos, sourceEnd, buffer, 64, 0, 0);
             if (resultPos)
             {
                 int8_t month;
                 int pm=0;
                 stZoneAbbreviation zone = stZoneAbbreviation_Invalid;
-
-                scanZone(scanPos, &zone);
+                const char* zoneEnd = scanZone(scanPos, sourceEnd, &zone);
                 if (buffer[0]=='P' && buffer[1]=='M' && buffer[2]==0) pm=1;
                 month = findMonth(buffer);
 
                 if (month && tp->tm_mon==INT_INVALID)
+                {
                     tp->tm_mon = month-1;
+                    addToken(pTokens, scanPos, resultPos, 'b');
+                }
                 else if (pm && tp->tm_hour!=INT_INVALID)
                 {
                     tp->tm_hour += 12;
                     if (tp->tm_hour == 24)
                         tp->tm_hour = 0;
+                    addToken(pTokens, scanPos, resultPos, 'p');
                 }
                 else if (zone.dst != (int8_t)0x80)
                 {
                     tp->tm_isdst = zone.dst;
                     if (pTimeZone) *pTimeZone = zone.zone;
+                    addToken(pTokens, scanPos, zoneEnd, 'Z');
                 }
                 scanPos = resultPos;
             }
@@ -1289,68 +2112,96 @@ const char* scanCalendar(const char* source, struct tm* tp, stTimeZone* pTimeZon
         else
         {   // number (type=1)
             int number = 0;
-            resultPos = scanInt(scanPos, &number, 0, 0, 1);
+            resultPos = scanInt(scanPos, sourceEnd, &number, 0, 0, 1);
             if (resultPos)
             {
                 int len = resultPos - scanPos;
+                char before, before2, after, after2;
                 if (*scanPos == '-' || *scanPos == '+')
                 {
                     scanPos++;
                     len--;
                 }
+                before = charAt(scanPos-1, source, sourceEnd);
+                before2 = charAt(scanPos-2, source, sourceEnd);
+                after = charAt(resultPos, source, sourceEnd);
+                after2 = charAt(resultPos+1, source, sourceEnd);
                 if (len>=3 && tp->tm_isdst==INT_INVALID)
                 {   // year
-                    if (tp->tm_year==INT_INVALID) tp->tm_year = number - 1900;
+                    if (tp->tm_year==INT_INVALID)
+                    {
+                        tp->tm_year = number - 1900;
+                        addToken(pTokens, scanPos, resultPos, 'Y');
+                    }
                 }
                 else
                 {   // year (2 digits), day, month, time
-                    if (*(scanPos-1)!=':' && *resultPos!=':' && tp->tm_isdst==INT_INVALID)
+                    if (before!=':' && after!=':' && tp->tm_isdst==INT_INVALID)
                     {
                         int isDay = 0;
-                        if ((*resultPos=='s' && *(resultPos+1)=='t') || (*resultPos=='n' && *(resultPos+1)=='d') || (*resultPos=='r' && *(resultPos+1)=='d') || (*resultPos=='t' && *(resultPos+1)=='h')) isDay = 1;
+                        if ((after=='s' && after2=='t') || (after=='n' && after2=='d') || (after=='r' && after2=='d') || (after=='t' && after2=='h')) isDay = 1;
                         if (number<0) number = -number;
                         // day?
-                        if (tp->tm_mday==INT_INVALID && (isDay || *resultPos=='.' || *resultPos==',' || (*(scanPos-1)=='-' && *resultPos!='-') || (*(scanPos-1)=='/' && *resultPos=='/')))
+                        if (tp->tm_mday==INT_INVALID && (isDay || after=='.' || after==',' || (before=='-' && after!='-') || (before=='/' && after=='/')))
                         {
                             tp->tm_mday = number;
+                            addToken(pTokens, scanPos, resultPos, 'd');
                         }
                         // month?
-                        else if (tp->tm_mon==INT_INVALID && ((tp->tm_mday!=INT_INVALID && *resultPos=='.') || (*(scanPos-1)=='-' && *resultPos=='-') || (*(scanPos-1)!='/' && *resultPos=='/')))
+                        else if (tp->tm_mon==INT_INVALID && ((tp->tm_mday!=INT_INVALID && after=='.') || (before=='-' && after=='-') || (before!='/' && after=='/')))
                         {
                             tp->tm_mon = number-1;
+                            addToken(pTokens, scanPos, resultPos, 'm');
                         }
                         // year?
-                        else if (tp->tm_year==INT_INVALID && (*(scanPos-1)=='.' || *(scanPos-1)=='\'' || (*(scanPos-1)!='-' && *resultPos=='-') || (*(scanPos-1)=='/' && *resultPos!='/')))
+                        else if (tp->tm_year==INT_INVALID && (before=='.' || before=='\'' || (before!='-' && after=='-') || (before=='/' && after!='/')))
                         {
                             number+=2000;
                             if (number>2068) number -= 100;
                             tp->tm_year = number - 1900;
+                            addToken(pTokens, scanPos, resultPos, 'y');
                         }
-                        if (*resultPos=='.')
+                        if (after=='.')
+                        {
                             resultPos++;
+                            after = charAt(resultPos, source, sourceEnd);
+                        }
                     }
-                    if ((*(scanPos-1)==':' || *resultPos==':') && tp->tm_isdst==INT_INVALID)
+                    if ((before==':' || after==':') && tp->tm_isdst==INT_INVALID)
                     {
-                        if (tp->tm_hour==INT_INVALID && *(scanPos-1)!=':' && *resultPos==':')
+                        if (tp->tm_hour==INT_INVALID && before!=':' && after==':')
+                        {
                             tp->tm_hour = number;
-                        if (tp->tm_min==INT_INVALID && *(scanPos-1)==':' && *resultPos==':')
+                            addToken(pTokens, scanPos, resultPos, 'H');
+                        }
+                        if (tp->tm_min==INT_INVALID && before==':' && after==':')
+                        {
                             tp->tm_min = number;
-                        if (tp->tm_sec==INT_INVALID && *(scanPos-1)==':' && *resultPos!=':')
+                            addToken(pTokens, scanPos, resultPos, 'M');
+                        }
+                        if (tp->tm_sec==INT_INVALID && before==':' && after!=':')
                         {
-                            if (tp->tm_min == INT_INVALID && *(scanPos-2)!=':')
+                            if (tp->tm_min == INT_INVALID && before2!=':')
+                            {
                                 tp->tm_min = number;
+                                addToken(pTokens, scanPos, resultPos, 'M');
+                            }
                             else
+                            {
                                 tp->tm_sec = number;
+                                addToken(pTokens, scanPos, resultPos, 'S');
+                            }
                         }
-                        if (*resultPos=='+' || *resultPos=='-')
+                        if (after=='+' || after=='-')
                         {
                             const char* resultPosZone;
                             stTimeZone timeZone;
-                            resultPosZone = scanTimeZone(resultPos, &timeZone);
+                            resultPosZone = scanTimeZone(resultPos, sourceEnd, &timeZone);
                             if (resultPosZone)
                             {
                                 if (pTimeZone) *pTimeZone = timeZone;
                                 tp->tm_isdst = -1;
+                                addToken(pTokens, resultPos, resultPosZone, 'z');
                                 resultPos = resultPosZone;
                             }
                         }
@@ -1359,9 +2210,271 @@ const char* scanCalendar(const char* source, struct tm* tp, stTimeZone* pTimeZon
                 scanPos = resultPos;
             }
         }
-        scanPos = scipNonLetters(scanPos, &type);
+        scanPos = scipNonLetters(scanPos, sourceEnd, &type);
     }
     return scanPos;
 }
 
+/**
+ * @brief Scans a calendar string and converts it to calendar data 'struct tm' and 'stTimeZone' without need of a format string.
+ * The string will be completely scanned until 'sourceEnd' is reached.
+ * @param source String to be scanned.
+ * @param sourceEnd End of the string, zero for a zero terminated string.
+ * @param tp Resulting calendar data.
+ * @param pTimeZone Resulting time zone. Might be set to zero.
+ * @return
+ */
+const char* scanCalendar(const char* source, const char* sourceEnd, struct tm* tp, stTimeZone* pTimeZone)
+{
+    return scanCalendarTokens(source, sourceEnd, tp, pTimeZone, 0);
+}
+
+/* Learning parser ------------------------------------------------------------------------- */
+
+/**
+ * @brief Checks characters being ignored by the automatic scan.
+ * @param position
+ * @param end
+ * @return 1 if there is no letter or digit, 0 otherwise.
+ */
+static int isIgnoredText(const char* position, const char* end)
+{
+    for (; position<end; position++)
+        if (isalnum((unsigned char)*position)) return 0;
+    return 1;
+}
+
+/**
+ * @brief Appends literal text to a format string.
+ * @param format
+ * @param formatSize
+ * @param pLength Length of 'format', updated.
+ * @param text
+ * @param textEnd
+ * @return 0 if the text contains '%' (not consumed by a format) or 'format' is too small, 1 otherwise.
+ */
+static int appendFormatText(char* format, size_t formatSize, size_t* pLength, const char* text, const char* textEnd)
+{
+    for (; text<textEnd; text++)
+    {
+        if (*text == '%' || *text == 0 || *pLength + 1 >= formatSize) return 0;
+        format[(*pLength)++] = *text;
+    }
+    return 1;
+}
+
+/**
+ * @brief Builds a format string reading the fields found by scanCalendarTokens() the same way.
+ * The characters between the fields are taken as literal text. So are the characters behind the last field
+ * up to the last letter or digit, as the automatic scan may interpret them differently in other strings (e.g. 'AM').
+ * @param format Resulting format string.
+ * @param formatSize Size of 'format'.
+ * @param source Scanned string.
+ * @param sourceEnd End of the scanned string.
+ * @param pTokens Fields of 'source'.
+ * @return Length of the format string. 0 if the fields can not be expressed by a format (PM, '%' characters, dropped fields) or 'format' is too small.
+ */
+static size_t formatFromTokens(char* format, size_t formatSize, const char* source, const char* sourceEnd, const stCalendarTokens* pTokens)
+{
+    const char* position = source;
+    size_t length = 0;
+    int n;
+    if (pTokens->count == 0 || pTokens->count > CALENDARTOKENS) return 0;
+    for (n=0; n<pTokens->count; n++)
+    {
+        const stCalendarToken* pToken = &pTokens->tokens[n];
+        if (pToken->symbol == 'p' || pToken->begin < position) return 0;
+        if (!appendFormatText(format, formatSize, &length, position, pToken->begin)) return 0;
+        if (length + 2 >= formatSize) return 0;
+        format[length++] = '%';
+        format[length++] = pToken->symbol;
+        position = pToken->end;
+    }
+    while (sourceEnd > position && !isalnum((unsigned char)sourceEnd[-1])) sourceEnd--;
+    if (!appendFormatText(format, formatSize, &length, position, sourceEnd)) return 0;
+    format[length] = 0;
+    return length;
+}
+
+/**
+ * @brief Compares the results of two scans.
+ * @param a
+ * @param zoneA
+ * @param b
+ * @param zoneB
+ * @return 1 if all entries set by LibOb_strnptime() are equal, 0 otherwise.
+ */
+static int equalCalendar(const struct tm* a, stTimeZone zoneA, const struct tm* b, stTimeZone zoneB)
+{
+    return a->tm_year == b->tm_year && a->tm_mon == b->tm_mon && a->tm_mday == b->tm_mday
+        && a->tm_hour == b->tm_hour && a->tm_min == b->tm_min && a->tm_sec == b->tm_sec
+        && a->tm_wday == b->tm_wday && a->tm_yday == b->tm_yday && a->tm_isdst == b->tm_isdst
+        && zoneA.hours == zoneB.hours && zoneA.minutes == zoneB.minutes;
+}
+
+/**
+ * @brief Checks the fields read by a learned format being read the same way by the automatic scan.
+ * Each field of the format has to be found. As the automatic scan takes numbers of three or more digits
+ * as year, '%Y' has to be at least 100 and all other numbers below 100.
+ * @param pProgram Learned format.
+ * @param tp Result of the learned format.
+ * @return 1 if the fields are valid, 0 otherwise.
+ */
+static int checkLearnedFields(const stFormatProgram* pProgram, const struct tm* tp)
+{
+    int n;
+    for (n=0; n<pProgram->count; n++)
+    {
+        switch (pProgram->instructions[n].symbol)
+        {
+        case 'Y':
+            if (tp->tm_year < 100-1900) return 0;
+            break;
+        case 'y':
+            if (tp->tm_year < 69 || tp->tm_year > 168) return 0;    // 1969 til 2068
+            break;
+        case 'm':
+            if ((unsigned int)(tp->tm_mon + 1) >= 100) return 0;
+            break;
+        case 'b':
+            if (tp->tm_mon == INT_INVALID) return 0;
+            break;
+        case 'd':
+            if ((unsigned int)tp->tm_mday >= 100) return 0;
+            break;
+        case 'H':
+            if ((unsigned int)tp->tm_hour >= 100) return 0;
+            break;
+        case 'M':
+            if ((unsigned int)tp->tm_min >= 100) return 0;
+            break;
+        case 'S':
+            if ((unsigned int)tp->tm_sec >= 100) return 0;
+            break;
+        case 'z':
+        case 'Z':
+            if (tp->tm_isdst == INT_INVALID) return 0;
+            break;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Derives a format string from a sample, the format reads the sample like the automatic scan does.
+ * The automatic scan (LibOb_strnptime() without format) assigns the numbers and names of a string to the calendar fields
+ * by their separators. The format string records this assignment, e.g. "20.09.2023 17:17:38 CEST" results in
+ * "%d.%m.%Y %H:%M:%S %Z" and "Sep 20th, 2023 5:17 PM" can not be expressed.
+ * @param format Resulting format string, empty in case of failure.
+ * @param formatSize Size of 'format'.
+ * @param source Sample string.
+ * @param sourceLength Number of characters of 'source'.
+ * @return Length of the format string, 0 if the scan of the sample can not be expressed as a format.
+ */
+size_t LibOb_learnFormat(char* format, size_t formatSize, const char* source, size_t sourceLength)
+{
+    stCalendarTokens tokens;
+    struct tm tmScan;
+    size_t length;
+    if (!format || formatSize == 0) return 0;
+    format[0] = 0;
+    if (!source) return 0;
+    scanCalendarTokens(source, source+sourceLength, &tmScan, 0, &tokens);
+    length = formatFromTokens(format, formatSize, source, source+sourceLength, &tokens);
+    if (!length) format[0] = 0;
+    return length;
+}
+
+/**
+ * @brief Initializes a learning parser, see LibOb_strnptimeLearning().
+ * @param pParser
+ * @param samples Number of consecutive samples resulting in the same format required to use that format.
+ * The same number of consecutive strings not matching the format drops it. Values below 1 are taken as 1.
+ */
+void LibOb_initLearningParser(stLearningParser* pParser, unsigned int samples)
+{
+    if (!pParser) return;
+    memset(pParser, 0, sizeof(stLearningParser));
+    pParser->samples = samples ? samples : 1;
+}
+
+/**
+ * @brief Converts a calendar string of unknown layout like LibOb_strnptime() without format, learning the layout of the strings of a stream.
+ * The first strings are read by the automatic scan. Their fields are recorded as format string (see LibOb_learnFormat()).
+ * When 'samples' consecutive strings result in the same format, being read by the compiled format identically to the
+ * automatic scan, the format is used for all further strings (pParser->hits). A string not matching the learned format
+ * (a field not found or outside the range the automatic scan assigns to that field, letters or digits left behind the format)
+ * is read by the automatic scan (pParser->misses). After 'samples' consecutive misses the format is dropped and learned again.
+ *
+ * As the automatic scan, the parser expects the time stamp only (e.g. the time stamp column of a log line), varying text
+ * behind it prevents learning.
+ * \code
+ * stLearningParser parser;
+ * LibOb_initLearningParser(&parser, LibOb_LEARNINGSAMPLES);
+ * for (each line)
+ *     LibOb_strnptimeLearning(&parser, line, lineLength, &tm, &zone);
+ * \endcode
+ * A parser is not thread safe, use one parser per stream.
+ * @param pParser Learning state, see LibOb_initLearningParser().
+ * @param source Input characters.
+ * @param sourceLength Number of characters of 'source' to be scanned at most.
+ * @param tp Output of numeric data set.
+ * @param pTimeZone Pointer to time zone data supplementing 'tp'. May be zero.
+ * @return Pointer to the first character of source not being consumed.
+ */
+const char* LibOb_strnptimeLearning(stLearningParser* pParser, const char* source, size_t sourceLength, struct tm* tp, stTimeZone* pTimeZone)
+{
+    stCalendarTokens tokens;
+    stTimeZone zone;
+    const char* result;
+    char candidate[LibOb_LEARNEDFORMAT];
+    if (!pParser) return LibOb_strnptime(source, sourceLength, 0, tp, pTimeZone);
+    if (!tp) return source;
+    if (pParser->format[0])
+    {
+        result = LibOb_strnptimeProgram(source, sourceLength, &pParser->program, tp, pTimeZone);
+        if (checkLearnedFields(&pParser->program, tp) && isIgnoredText(result, source+sourceLength))
+        {
+            pParser->hits++;
+            pParser->failures = 0;
+            return result;
+        }
+        pParser->misses++;
+        if (++pParser->failures >= pParser->samples)
+        {   // layout changed, learn again
+            pParser->format[0] = 0;
+            pParser->agreeing = 0;
+        }
+        return scanCalendar(source, source+sourceLength, tp, pTimeZone);
+    }
+
+    pParser->misses++;
+    result = scanCalendarTokens(source, source+sourceLength, tp, &zone, &tokens);
+    if (pTimeZone) *pTimeZone = zone;
+    if (formatFromTokens(candidate, sizeof(candidate), source, source+sourceLength, &tokens) && LibOb_compileFormat(&pParser->program, candidate))
+    {
+        struct tm tmProgram;
+        stTimeZone zoneProgram;
+        const char* end = LibOb_strnptimeProgram(source, sourceLength, &pParser->program, &tmProgram, &zoneProgram);
+        if (equalCalendar(tp, zone, &tmProgram, zoneProgram) && checkLearnedFields(&pParser->program, &tmProgram) && isIgnoredText(end, source+sourceLength))
+        {
+            if (pParser->agreeing && strcmp(candidate, pParser->candidate) == 0)
+                pParser->agreeing++;
+            else
+            {
+                strcpy(pParser->candidate, candidate);
+                pParser->agreeing = 1;
+            }
+            if (pParser->agreeing >= pParser->samples)
+            {
+                strcpy(pParser->format, candidate);
+                pParser->failures = 0;
+            }
+            return result;
+        }
+    }
+    pParser->agreeing = 0;
+    return result;
+}
+
 /** @} */
@@ -23,6 +23,12 @@
 #define INT64_INVALID ((int64_t)0x8000000000000000)     ///< Invalid int64_t
 #define UINT64_INVALID 0xFFFFFFFFFFFFFFFF               ///< Invalid uint64_t
 
+#define LibOb_DEFAULTFORMAT "%Y-%m-%d#%H:%M:%S#%U#%z"   ///< Format used for zero or empty format strings (\ref GZC)
+#define LibOb_FORMATINSTRUCTIONS 32                     ///< Maximum number of instructions of a stFormatProgram
+#define LibOb_FORMATLITERALS 64                         ///< Maximum number of literal characters of a stFormatProgram
+#define LibOb_LEARNEDFORMAT 64                          ///< Maximum size of a format string learned by a stLearningParser
+#define LibOb_LEARNINGSAMPLES 8                         ///< Default number of samples of a stLearningParser
+
 #define LibOb_isLeapYear(y) ((((y) % 4) == 0 && ((y) % 100) != 0) || ((y) % 400) == 0) ///< Checks a year being a leap year
 
 #include <ctype.h>
@@ -76,6 +82,57 @@ typedef struct _stZoneAbbreviation
 extern const stZoneAbbreviation stZoneAbbreviation_Ini;         ///< Initializer for stZoneAbbreviation
 extern const stZoneAbbreviation stZoneAbbreviation_Invalid;     ///< Invalidates all entries of stZoneAbbreviation
 
+/**
+ * @brief Kind of a stFormatInstruction
+**/
+enum enFormatInstruction
+{
+    LibOb_FORMAT_LITERAL = 0,   ///< Literal characters
+    LibOb_FORMAT_NUMBER  = 1,   ///< Fixed width number of a struct tm entry
+    LibOb_FORMAT_FIELD   = 2    ///< Any other format symbol
+};
+
+/**
+ * @brief One step of a compiled format, see LibOb_compileFormat().
+**/
+typedef struct _stFormatInstruction
+{
+    uint8_t  type;          ///< enFormatInstruction
+    char     symbol;        ///< Format symbol, e.g. 'Y'
+    uint8_t  modifier;      ///< Length modifier 1 or 2 ('%1m'), 0 if not given
+    uint8_t  width;         ///< Number of digits of a number, number of characters of a literal
+    uint16_t offset;        ///< Offset of the struct tm entry of a number, index into 'literals' for a literal
+    int16_t  addend;        ///< Value added to the struct tm entry of a number (e.g. 1900 for tm_year)
+} stFormatInstruction;
+
+/**
+ * @brief Format string compiled once for many calls of LibOb_strftimeProgram() and LibOb_strnptimeProgram().
+ * The struct contains no pointers, it may be copied and shared by threads.
+**/
+typedef struct _stFormatProgram
+{
+    uint8_t  count;                                             ///< Number of used instructions
+    uint16_t literalCount;                                      ///< Number of used literal characters
+    stFormatInstruction instructions[LibOb_FORMATINSTRUCTIONS]; ///< Instructions
+    char     literals[LibOb_FORMATLITERALS];                    ///< Literal characters of all literal instructions (not terminated)
+} stFormatProgram;
+
+/**
+ * @brief Parser learning the layout of calendar strings, see LibOb_strnptimeLearning().
+ * Initialize with LibOb_initLearningParser().
+**/
+typedef struct _stLearningParser
+{
+    stFormatProgram program;                    ///< Compiled 'format' (the latest candidate while learning)
+    char     format[LibOb_LEARNEDFORMAT];       ///< Learned format string, empty while learning
+    char     candidate[LibOb_LEARNEDFORMAT];    ///< Format string derived from the latest samples
+    uint32_t samples;                           ///< Number of agreeing samples to learn a format, number of consecutive misses to drop it
+    uint32_t agreeing;                          ///< Number of consecutive samples resulting in 'candidate'
+    uint32_t failures;                          ///< Number of consecutive strings not matching 'format'
+    uint64_t hits;                              ///< Number of strings read by the learned format
+    uint64_t misses;                            ///< Number of strings read by the automatic scan (while learning or not matching)
+} stLearningParser;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -84,6 +141,15 @@ extern "C" {
 
 size_t      LibOb_strftime(char* destination, size_t destinationSize, const char* format, const struct tm* tp, stTimeZone* pTimeZone, enum enLanguage* pLanguage); ///< Converts struct tm to formatted character string
 const char* LibOb_strptime(const char* source, const char* format, struct tm* tp, stTimeZone* pTimeZone);   ///< Converts a time string to calendrical time data stored in 'struct tm'.
+const char* LibOb_strnptime(const char* source, size_t sourceLength, const char* format, struct tm* tp, stTimeZone* pTimeZone); ///< Converts a time string of given length (not zero terminated) to calendrical time data stored in 'struct tm'.
+size_t      LibOb_strftimeNano(char* destination, size_t destinationSize, const char* format, const struct tm* tp, stTimeZone* pTimeZone, enum enLanguage* pLanguage, uint32_t nanoSeconds); ///< LibOb_strftime writing the fraction of the second (%f)
+const char* LibOb_strnptimeNano(const char* source, size_t sourceLength, const char* format, struct tm* tp, stTimeZone* pTimeZone, uint32_t* pNanoSeconds); ///< LibOb_strnptime reading the fraction of the second (%f)
+int         LibOb_compileFormat(stFormatProgram* pProgram, const char* format);                              ///< Compiles a format string for repeated use.
+size_t      LibOb_strftimeProgram(char* destination, size_t destinationSize, const stFormatProgram* pProgram, const struct tm* tp, stTimeZone* pTimeZone, enum enLanguage* pLanguage); ///< LibOb_strftime using a compiled format
+const char* LibOb_strnptimeProgram(const char* source, size_t sourceLength, const stFormatProgram* pProgram, struct tm* tp, stTimeZone* pTimeZone);                        ///< LibOb_strnptime using a compiled format
+size_t      LibOb_learnFormat(char* format, size_t formatSize, const char* source, size_t sourceLength);      ///< Derives a format string reading a sample like the automatic scan does.
+void        LibOb_initLearningParser(stLearningParser* pParser, unsigned int samples);                      ///< Initializes a stLearningParser.
+const char* LibOb_strnptimeLearning(stLearningParser* pParser, const char* source, size_t sourceLength, struct tm* tp, stTimeZone* pTimeZone); ///< LibOb_strnptime without format, learning the layout of a stream of strings
 stTimeZone  LibOb_localTimeZone(int8_t* pDst);                                                              ///< Retrieves time zone and dst from local system clock settings
 
 int         LibOb_checkStructTm(struct tm* pTm, struct tm tmCheckConfig, int isDuration);                   ///< Checks struct tm having valid entries.
@@ -93,12 +159,14 @@ stTimeZone  LibOb_timeZone(const char* timeZoneStr, int8_t* pDst);
 /* General string related scan functions -------------------------------------------------- */
 
 int         isnumber(unsigned char character);                                                              ///< Checks a character being part of a number string. See isnumber .
-const char* scipSpace(const char* source);                                                                  ///< Scans until no more white space is found.
-const char* scipDigits(const char* source);                                                                 ///< Scans until no more digits are found.
-const char* scipNonLetters(const char* source, int* type);                                                  ///< Scans until a digit or letter character is found
-const char* scanUint(const char* source, unsigned int* result, int scip, int allowPlus, int allowLaggingDot);           ///< Converts a character string to a unsigned integer.
-const char* scanInt(const char* source, int* result, int scip, int requiredPlus, int allowLaggingDot);      ///< Converts a character string to an integer.
-const char* scanExpression(const char* source, char* destination, size_t destinationSize, int scip, int allowNumber); ///< Scans (and copies) the next expression.
+/* The scan functions read up to 'sourceEnd' (exclusive). Set 'sourceEnd' to zero for zero terminated strings.      */
+
+const char* scipSpace(const char* source, const char* sourceEnd);                                           ///< Scans until no more white space is found.
+const char* scipDigits(const char* source, const char* sourceEnd);                                          ///< Scans until no more digits are found.
+const char* scipNonLetters(const char* source, const char* sourceEnd, int* type);                           ///< Scans until a digit or letter character is found
+const char* scanUint(const char* source, const char* sourceEnd, unsigned int* result, int scip, int allowPlus, int allowLaggingDot);  ///< Converts a character string to a unsigned integer.
+const char* scanInt(const char* source, const char* sourceEnd, int* result, int scip, int requiredPlus, int allowLaggingDot);        ///< Converts a character string to an integer.
+const char* scanExpression(const char* source, const char* sourceEnd, char* destination, size_t destinationSize, int scip, int allowNumber); ///< Scans (and copies) the next expression.
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,839 @@
+// utf-8 (ü)
+/**
+ * @file   benchmark.cpp
+ * @author Olaf Simon
+ * @brief  Run time measurements of the cTime and LibOb_strptime implementations.
+ *
+ * The measurements are started by calling the demonstration program with the argument 'benchmark'.
+ * Each measurement prints the mean time per call. Where the implementation replaced system
+ * library calls, the equivalent sequence of library calls is measured as reference.
+**/
+
+#include "benchmark.h"
+#include "LibCpp/Time/cTime.h"
+#include "LibCpp/Time/cCalendarMath.h"
+#include "LibCpp/Time/cCalendarView.h"
+#include "LibCpp/Time/cTimeFormat.h"
+#include "LibCpp/Time/cLogTimes.h"
+#include "LibCpp/Time/cPackedTime.h"
+#include "LibCpp/Time/cZoneInfo.h"
+#include "LibCpp/Time/cZoneRule.h"
+#include "LibCpp/Time/cZonedTime.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+using namespace LibCpp;
+using namespace std;
+
+static volatile int64_t benchmarkSink = 0;  ///< Prevents the compiler from removing the measured code.
+
+/**
+ * @brief Measures the mean run time of 'function' being called 'count' times.
+ * @param function Callable receiving the loop index.
+ * @param count Number of calls.
+ * @return Nanoseconds per call
+ */
+template <typename F> static double nsPerCall(F function, size_t count)
+{
+    auto start = chrono::steady_clock::now();
+    for (size_t i=0; i<count; i++)
+        function(i);
+    auto stop = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(stop - start).count() / (double)count;
+}
+
+/**
+ * @brief Prints a single measurement result.
+ * @param name
+ * @param ns Nanoseconds per call
+ */
+static void report(const char* name, double ns)
+{
+    printf("%-48s %9.1f ns/call %12.0f calls/s\n", name, ns, 1e9 / ns);
+}
+
+/**
+ * @brief Unix time samples spread over the years 1970 till 2100.
+ * @param count
+ * @return Samples
+ */
+static vector<time_t> timeSamples(size_t count)
+{
+    vector<time_t> samples(count);
+    uint64_t x = 88172645463325252ull;
+    for (size_t i=0; i<count; i++)
+    {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        samples[i] = (time_t)(x % 4102444800ull);
+    }
+    return samples;
+}
+
+/**
+ * @brief Calendar conversion: arithmetic engine against localtime / mktime.
+ */
+static void benchmarkCalendar()
+{
+    const size_t count = 1000000;
+    vector<time_t> samples = timeSamples(4096);
+    int8_t offset = 5;
+
+    printf("------- Benchmark: calendar conversion ---------\n");
+    report("libc gmtime_s", nsPerCall([&](size_t i) {
+        struct tm t; gmtime_s(&t, &samples[i & 4095]); benchmarkSink += t.tm_mday; }, count));
+    report("libc localtime_s", nsPerCall([&](size_t i) {
+        struct tm t; localtime_s(&t, &samples[i & 4095]); benchmarkSink += t.tm_mday; }, count));
+    report("libc localtime_s + mktime (former offset path)", nsPerCall([&](size_t i) {
+        struct tm t; localtime_s(&t, &samples[i & 4095]); t.tm_hour += offset; benchmarkSink += mktime(&t); }, count));
+    report("cTime::unixToCalendar", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::unixToCalendar(samples[i & 4095]).day; }, count));
+    report("cTime::calendar(&offset)", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::set(samples[i & 4095]).calendar(&offset).day; }, count));
+    report("cTime::calendar()", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::set(samples[i & 4095]).calendar().day; }, count));
+
+    stCalendar calendar = cTime::unixToCalendar(1695223058, stTimeZone_Ini, -1);
+    report("libc mktime", nsPerCall([&](size_t i) {
+        struct tm t = tm_Ini; t.tm_year = 123; t.tm_mon = 8; t.tm_mday = 20; t.tm_sec = (int)(i & 4095); t.tm_isdst = -1; benchmarkSink += mktime(&t); }, count));
+    report("cTime::set(stCalendar)", nsPerCall([&](size_t i) {
+        calendar.second = (uint8_t)(i & 63); benchmarkSink += cTime::set(calendar).time(); }, count));
+}
+
+/**
+ * @brief Local time zone: cached zone context against LibOb_localTimeZone.
+ */
+static void benchmarkLocalTimeZone()
+{
+    const size_t count = 1000000;
+
+    printf("------- Benchmark: local time zone ---------\n");
+    report("LibOb_localTimeZone", nsPerCall([&](size_t) {
+        benchmarkSink += LibOb_localTimeZone(nullptr).hours; }, count));
+    report("cTime::localTimeZone", nsPerCall([&](size_t) {
+        benchmarkSink += cTime::localTimeZone().hours; }, count));
+    report("cTime::checkZoneContext", nsPerCall([&](size_t) {
+        benchmarkSink += cTime::checkZoneContext(); }, count / 100));
+    benchmarkSink += cTime::localTimeZone().hours;
+    printf("zone context computations: %llu\n", (unsigned long long)cTime::zoneContextRecomputations());
+}
+
+/**
+ * @brief Column conversion: cTime::calendarColumns against cTime::unixToCalendar.
+ */
+static void benchmarkCalendarColumns()
+{
+    const size_t count = 1 << 20;
+    vector<time_t> samples = timeSamples(count);
+    vector<int32_t>  year(count);
+    vector<uint8_t>  month(count), day(count), hour(count), minute(count), second(count), dayInWeek(count);
+    vector<uint16_t> dayInYear(count);
+    stCalendarColumns columns = {year.data(), month.data(), day.data(), hour.data(), minute.data(), second.data(), dayInWeek.data(), dayInYear.data()};
+
+    printf("------- Benchmark: calendar columns ---------\n");
+    double ns = nsPerCall([&](size_t i) {
+        stCalendar c = cTime::unixToCalendar(samples[i]);
+        year[i] = c.year; month[i] = c.month; day[i] = c.day; hour[i] = c.hour; minute[i] = c.minute; second[i] = c.second; dayInWeek[i] = c.dayInWeek; dayInYear[i] = c.dayInYear; }, count);
+    report("cTime::unixToCalendar per value", ns);
+    ns = nsPerCall([&](size_t) { cTime::calendarColumns(samples.data(), count, columns); }, 10) / count;
+    report("cTime::calendarColumns (all columns) per value", ns);
+    stCalendarColumns hours = stCalendarColumns_Ini;
+    hours.hour = hour.data();
+    ns = nsPerCall([&](size_t) { cTime::calendarColumns(samples.data(), count, hours); }, 10) / count;
+    report("cTime::calendarColumns (hour column) per value", ns);
+    benchmarkSink += year[count / 2] + hour[count / 3];
+}
+
+/**
+ * @brief GZC string conversion: cTime::scanGZC against the general conversion.
+ */
+static void benchmarkScanGZC()
+{
+    const size_t count = 1000000;
+    vector<time_t> samples = timeSamples(4096);
+    vector<string> strings(samples.size());
+    for (size_t i=0; i<samples.size(); i++)
+        strings[i] = cTime::toString(cTime::unixToCalendar(samples[i], {1, 0}, (int8_t)(i & 1)));
+
+    printf("------- Benchmark: GZC string conversion ---------\n");
+    report("LibOb_strptime (no format)", nsPerCall([&](size_t i) {
+        struct tm t; stTimeZone zone; LibOb_strptime(strings[i & 4095].c_str(), 0, &t, &zone); benchmarkSink += t.tm_mday; }, count));
+    report("cTime::set(cTime::fromString())", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::set(cTime::fromString(strings[i & 4095], "")).time(); }, count));
+    report("cTime::scanGZC", nsPerCall([&](size_t i) {
+        time_t t = 0; cTime::scanGZC(strings[i & 4095].c_str(), &t); benchmarkSink += t; }, count));
+    report("cTime::set(std::string)", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::set(strings[i & 4095]).time(); }, count));
+}
+
+/**
+ * @brief String formatting: LibOb_strftime and cTime::toString.
+ */
+static void benchmarkFormat()
+{
+    const size_t count = 1000000;
+    vector<time_t> samples = timeSamples(4096);
+    vector<stCalendar> calendars(samples.size());
+    vector<struct tm> tms(samples.size());
+    for (size_t i=0; i<samples.size(); i++)
+    {
+        calendars[i] = cTime::unixToCalendar(samples[i], {1, 0}, (int8_t)(i & 1));
+        tms[i] = cTime::fromCalendar(calendars[i]);
+    }
+    stTimeZone zone = {1, 0};
+    char buffer[64];
+
+    printf("------- Benchmark: string formatting ---------\n");
+    report("libc snprintf (GZC layout)", nsPerCall([&](size_t i) {
+        const struct tm& t = tms[i & 4095];
+        benchmarkSink += snprintf(buffer, 64, "%04d-%02d-%02d#%02d:%02d:%02d#%s#%+03d:%02u", t.tm_year+1900, t.tm_mon+1, t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec, t.tm_isdst ? "DST" : "STD", 1, 0u); }, count));
+    report("LibOb_strftime (default format)", nsPerCall([&](size_t i) {
+        LibOb_strftime(buffer, 64, nullptr, &tms[i & 4095], &zone, nullptr); benchmarkSink += buffer[18]; }, count));
+    report("LibOb_strftime (\"%A %Y-%m-%d %H:%M:%S %Z\")", nsPerCall([&](size_t i) {
+        LibOb_strftime(buffer, 64, "%A %Y-%m-%d %H:%M:%S %Z", &tms[i & 4095], &zone, nullptr); benchmarkSink += buffer[18]; }, count));
+    report("cTime::toString(stCalendar)", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::toString(calendars[i & 4095]).size(); }, count));
+}
+
+/**
+ * @brief Parsing time stamps within a log buffer: copying each time stamp against parsing in place.
+ */
+static void benchmarkParseInPlace()
+{
+    const size_t count = 1000000;
+    const string format = "%Y-%m-%d %H:%M:%S %Z";
+    vector<time_t> samples = timeSamples(4096);
+    string log;
+    vector<size_t> lines(samples.size()), lengths(samples.size());
+    for (size_t i=0; i<samples.size(); i++)
+    {
+        string stamp = cTime::toString(cTime::unixToCalendar(samples[i], {1, 0}, (int8_t)(i & 1)), format);
+        lines[i] = log.size();
+        lengths[i] = stamp.size();
+        log += stamp + " | message of the log line\n";
+    }
+
+    printf("------- Benchmark: parsing within a buffer ---------\n");
+    report("LibOb_strptime (std::string copy)", nsPerCall([&](size_t i) {
+        struct tm t; stTimeZone zone; string copy(log.data() + lines[i & 4095], lengths[i & 4095]);
+        LibOb_strptime(copy.c_str(), format.c_str(), &t, &zone); benchmarkSink += t.tm_mday; }, count));
+    report("LibOb_strnptime (in place)", nsPerCall([&](size_t i) {
+        struct tm t; stTimeZone zone;
+        LibOb_strnptime(log.data() + lines[i & 4095], lengths[i & 4095], format.c_str(), &t, &zone); benchmarkSink += t.tm_mday; }, count));
+    report("cTime::set(std::string(...), format)", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::set(string(log.data() + lines[i & 4095], lengths[i & 4095]), format).time(); }, count));
+    report("cTime::set(std::string_view, format)", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::set(string_view(log.data() + lines[i & 4095], lengths[i & 4095]), format).time(); }, count));
+}
+
+/**
+ * @brief Header only calendar arithmetic: inlined calendarMath functions against the cTime methods.
+ */
+static void benchmarkCalendarMath()
+{
+    const size_t count = 1000000;
+    vector<time_t> samples = timeSamples(4096);
+    constexpr time_t midnight2024 = calendarMath::unixTime(2024, 1, 1);
+
+    printf("------- Benchmark: calendar math ---------\n");
+    report("cTime::unixToCalendar", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::unixToCalendar(samples[i & 4095]).day; }, count));
+    report("calendarMath::unixToCalendar (inlined)", nsPerCall([&](size_t i) {
+        benchmarkSink += calendarMath::unixToCalendar(samples[i & 4095]).day; }, count));
+    report("cTime::daysFromCivil", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::daysFromCivil(1970 + (int32_t)(i & 127), (uint8_t)(1 + (i & 7)), (uint8_t)(1 + (i & 15))); }, count));
+    report("calendarMath::daysFromCivil (inlined)", nsPerCall([&](size_t i) {
+        benchmarkSink += calendarMath::daysFromCivil(1970 + (int32_t)(i & 127), 1 + (i & 7), 1 + (i & 15)); }, count));
+    report("calendarMath::unixTime (constant)", nsPerCall([&](size_t i) {
+        benchmarkSink += samples[i & 4095] >= midnight2024; }, count));
+}
+
+/**
+ * @brief Compiled formats: LibOb_strftimeProgram / LibOb_strnptimeProgram against the interpreting functions.
+ */
+static void benchmarkFormatProgram()
+{
+    const size_t count = 1000000;
+    vector<time_t> samples = timeSamples(4096);
+    vector<struct tm> tms(samples.size());
+    vector<string> stamps(samples.size());
+    stTimeZone zone = {1, 0};
+    for (size_t i=0; i<samples.size(); i++)
+    {
+        stCalendar calendar = cTime::unixToCalendar(samples[i], zone, (int8_t)(i & 1));
+        tms[i] = cTime::fromCalendar(calendar);
+        stamps[i] = cTime::toString(calendar);
+    }
+    stFormatProgram program;
+    LibOb_compileFormat(&program, LibOb_DEFAULTFORMAT);
+    char buffer[64];
+
+    printf("------- Benchmark: compiled formats ---------\n");
+    report("LibOb_strftime (default format)", nsPerCall([&](size_t i) {
+        LibOb_strftime(buffer, 64, LibOb_DEFAULTFORMAT, &tms[i & 4095], &zone, nullptr); benchmarkSink += buffer[18]; }, count));
+    report("LibOb_strftimeProgram (default format)", nsPerCall([&](size_t i) {
+        LibOb_strftimeProgram(buffer, 64, &program, &tms[i & 4095], &zone, nullptr); benchmarkSink += buffer[18]; }, count));
+    report("LibOb_strnptime (default format)", nsPerCall([&](size_t i) {
+        struct tm t; stTimeZone z; const string& s = stamps[i & 4095];
+        LibOb_strnptime(s.data(), s.size(), LibOb_DEFAULTFORMAT, &t, &z); benchmarkSink += t.tm_mday; }, count));
+    report("LibOb_strnptimeProgram (default format)", nsPerCall([&](size_t i) {
+        struct tm t; stTimeZone z; const string& s = stamps[i & 4095];
+        LibOb_strnptimeProgram(s.data(), s.size(), &program, &t, &z); benchmarkSink += t.tm_mday; }, count));
+}
+
+/**
+ * @brief Compile time formats: cTime::toString with LibCpp_TIMEFORMAT against the format string.
+ */
+static void benchmarkCompileTimeFormat()
+{
+    const size_t count = 1000000;
+    vector<time_t> samples = timeSamples(4096);
+    vector<stCalendar> calendars(samples.size());
+    for (size_t i=0; i<samples.size(); i++)
+        calendars[i] = cTime::unixToCalendar(samples[i], {1, 0}, (int8_t)(i & 1));
+    auto isoFormat = LibCpp_TIMEFORMAT("%Y-%m-%d %H:%M:%S");
+    auto defaultFormat = LibCpp_TIMEFORMAT("");
+    char buffer[timeFormat::length<decltype(isoFormat)> + 1];
+
+    printf("------- Benchmark: compile time formats ---------\n");
+    report("cTime::toString(stCalendar, \"%Y-%m-%d %H:%M:%S\")", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::toString(calendars[i & 4095], "%Y-%m-%d %H:%M:%S").size(); }, count));
+    report("cTime::toString(stCalendar, LibCpp_TIMEFORMAT)", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::toString(calendars[i & 4095], isoFormat).size(); }, count));
+    report("timeFormat::format (stack buffer)", nsPerCall([&](size_t i) {
+        benchmarkSink += timeFormat::format(buffer, calendars[i & 4095], isoFormat); }, count));
+    report("cTime::toString(stCalendar) (default format)", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::toString(calendars[i & 4095]).size(); }, count));
+    report("cTime::toString(stCalendar, LibCpp_TIMEFORMAT(\"\"))", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::toString(calendars[i & 4095], defaultFormat).size(); }, count));
+}
+
+/**
+ * @brief Zone abbreviations: name to zone (LibOb_timeZone) and zone to name (LibOb_strftime "%Z").
+ */
+static void benchmarkZoneLookup()
+{
+    const size_t count = 1000000;
+    const char* names[8] = {"CET", "CEST", "PST", "NZDT", "MIT", "CHADT", "IST", "XYZ"};
+    const stTimeZone zones[8] = {{1, 0}, {-8, 0}, {12, 45}, {-9, 30}, {5, 45}, {0, 0}, {3, 15}, {14, 0}};
+    struct tm t = tm_Ini;
+    char buffer[32];
+
+    printf("------- Benchmark: zone abbreviations ---------\n");
+    report("LibOb_timeZone (name -> zone)", nsPerCall([&](size_t i) {
+        int8_t dst = 0; benchmarkSink += LibOb_timeZone(names[i & 7], &dst).hours; }, count));
+    report("LibOb_strftime \"%Z\" (zone -> name)", nsPerCall([&](size_t i) {
+        stTimeZone zone = zones[i & 7]; t.tm_isdst = (int)((i >> 3) & 1);
+        benchmarkSink += (int64_t)LibOb_strftime(buffer, 32, "%Z", &t, &zone, nullptr); }, count));
+}
+
+/**
+ * @brief Month and day names: LibOb_strnptime with "%a %d %B %Y" over names of all languages.
+ */
+static void benchmarkNames()
+{
+    const size_t count = 1000000;
+    const char* lines[8] = {"Mon 20 January 2023", "Tuesday 21 september 2023", "Mi 22 Dezember 2023", "THU 23 Oct 2023",
+                            "Fr 24 Mrz 2023", "Samstag 25 Mai 2023", "sun 26 DEC 2023", "Montag 27 Oktober 2023"};
+    size_t lengths[8];
+    for (size_t i=0; i<8; i++)
+        lengths[i] = strlen(lines[i]);
+
+    printf("------- Benchmark: month and day names ---------\n");
+    report("LibOb_strnptime (\"%a %d %B %Y\")", nsPerCall([&](size_t i) {
+        struct tm t; LibOb_strnptime(lines[i & 7], lengths[i & 7], "%a %d %B %Y", &t, nullptr); benchmarkSink += t.tm_mon + t.tm_wday; }, count));
+}
+
+/**
+ * @brief Learning parser: automatic scan of every line against the learned format.
+ */
+static void benchmarkLearningParser()
+{
+    const size_t count = 1000000;
+    vector<time_t> samples = timeSamples(4096);
+    vector<string> stamps(samples.size());
+    for (size_t i=0; i<samples.size(); i++)
+        stamps[i] = cTime::toString(cTime::unixToCalendar(samples[i], {1, 0}, (int8_t)(i & 1)), "%d.%m.%Y %H:%M:%S %Z");
+    stLearningParser parser;
+    LibOb_initLearningParser(&parser, LibOb_LEARNINGSAMPLES);
+
+    printf("------- Benchmark: learning parser ---------\n");
+    report("LibOb_strnptime (automatic scan)", nsPerCall([&](size_t i) {
+        struct tm t; stTimeZone z; const string& s = stamps[i & 4095];
+        LibOb_strnptime(s.data(), s.size(), nullptr, &t, &z); benchmarkSink += t.tm_mday; }, count));
+    report("LibOb_strnptimeLearning", nsPerCall([&](size_t i) {
+        struct tm t; stTimeZone z; const string& s = stamps[i & 4095];
+        LibOb_strnptimeLearning(&parser, s.data(), s.size(), &t, &z); benchmarkSink += t.tm_mday; }, count));
+    printf("learned format \"%s\", hits %llu, misses %llu\n", parser.format, (unsigned long long)parser.hits, (unsigned long long)parser.misses);
+}
+
+/**
+ * @brief Sets the TZ environment variable and lets the C library read it.
+ * @param tz Value, zero to remove the variable.
+ */
+static void setTZ(const char* tz)
+{
+#ifdef _WIN32
+    _putenv_s("TZ", tz ? tz : "");
+#else
+    if (tz) setenv("TZ", tz, 1);
+    else unsetenv("TZ");
+#endif
+    tzset();
+}
+
+/**
+ * @brief Geographic zones: cZoneInfo loading and conversion against switching TZ for localtime.
+ */
+static void benchmarkZoneInfo()
+{
+    const size_t count = 1000000;
+    const char* names[4] = {"Europe/Berlin", "America/New_York", "Australia/Sydney", "Asia/Kolkata"};
+    cZoneInfo zones[4];
+    for (size_t i=0; i<4; i++)
+        if (!zones[i].load(names[i])) return;
+    vector<time_t> samples = timeSamples(4096);
+    const char* tzBefore = getenv("TZ");
+    string tzSaved = tzBefore ? tzBefore : "";
+
+    printf("------- Benchmark: geographic zones (time zone data base) ---------\n");
+    report("cZoneInfo::load", nsPerCall([&](size_t i) {
+        cZoneInfo zone; zone.load(names[i & 3]); benchmarkSink += zone.transitionCount(); }, 10000));
+    report("cZoneInfo::calendar", nsPerCall([&](size_t i) {
+        benchmarkSink += zones[(i >> 12) & 3].calendar(samples[i & 4095]).hour; }, count));
+    report("setenv(TZ) + tzset + localtime (zone switch)", nsPerCall([&](size_t i) {
+        struct tm t; setTZ(names[i & 3]); localtime_s(&t, &samples[i & 4095]); benchmarkSink += t.tm_hour; }, count / 10));
+    setTZ(names[0]);
+    report("localtime (TZ set once)", nsPerCall([&](size_t i) {
+        struct tm t; localtime_s(&t, &samples[i & 4095]); benchmarkSink += t.tm_hour; }, count));
+    setTZ(tzBefore ? tzSaved.c_str() : nullptr);
+}
+
+/**
+ * @brief POSIX TZ rules: cZoneRule conversions against mktime and localtime with the rule as TZ.
+ */
+static void benchmarkZoneRule()
+{
+    const size_t count = 1000000;
+    const char* rules[4] = {"CET-1CEST,M3.5.0,M10.5.0/3", "EST5EDT,M3.2.0,M11.1.0", "AEST-10AEDT,M10.1.0,M4.1.0/3", "IST-5:30"};
+    cZoneRule zones[4];
+    for (size_t i=0; i<4; i++)
+        if (!zones[i].parse(rules[i])) return;
+    vector<time_t> samples = timeSamples(4096);
+    vector<stCalendar> wallClocks(4096);
+    for (size_t i=0; i<4096; i++)
+    {
+        wallClocks[i] = zones[0].calendar(samples[i]);
+        wallClocks[i].timeZone.hours = INT8_INVALID;
+        wallClocks[i].dst = INT8_INVALID;
+    }
+    const char* tzBefore = getenv("TZ");
+    string tzSaved = tzBefore ? tzBefore : "";
+
+    printf("------- Benchmark: POSIX TZ rules ---------\n");
+    report("cZoneRule::parse", nsPerCall([&](size_t i) {
+        cZoneRule zone; zone.parse(rules[i & 3]); benchmarkSink += zone.dstOffset(); }, 100000));
+    report("cZoneRule::transitions (uncached)", nsPerCall([&](size_t i) {
+        cZoneRule zone(zones[i & 3]); time_t begin = 0, end = 0; zone.transitions(1970 + (int32_t)(i & 127), &begin, &end); benchmarkSink += begin + end; }, count / 10));
+    report("cZoneRule::calendar", nsPerCall([&](size_t i) {
+        benchmarkSink += zones[(i >> 12) & 3].calendar(samples[i & 4095]).hour; }, count));
+    report("cTime::set(stCalendar, cZoneRule)", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::set(wallClocks[i & 4095], zones[0]).time(); }, count));
+    setTZ(rules[0]);
+    report("localtime (TZ = rule)", nsPerCall([&](size_t i) {
+        struct tm t; localtime_s(&t, &samples[i & 4095]); benchmarkSink += t.tm_hour; }, count));
+    report("cTime::set(stCalendar) (mktime, TZ = rule)", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::set(wallClocks[i & 4095]).time(); }, count));
+    setTZ(tzBefore ? tzSaved.c_str() : nullptr);
+}
+
+/**
+ * @brief Sub second resolution: cTime::now() with nano seconds and the fraction symbol '%f'.
+ */
+static void benchmarkSubSecond()
+{
+    const size_t count = 1000000;
+    vector<time_t> samples = timeSamples(4096);
+    vector<string> stamps(samples.size());
+    for (size_t n=0; n<samples.size(); n++)
+        stamps[n] = cTime::toString(cTime::set(samples[n], (int64_t)(n * 244140625)).calendar(cTime::UTC), "%Y-%m-%d %H:%M:%S.%f %z");
+    auto fractionFormat = LibCpp_TIMEFORMAT("%Y-%m-%d %H:%M:%S.%f");
+    stCalendar calendar = cTime::set(samples[0], 123456789).calendar(cTime::UTC);
+    char buffer[64];
+
+    printf("------- Benchmark: sub second resolution ---------\n");
+    report("libc time", nsPerCall([&](size_t) {
+        benchmarkSink += ::time(nullptr); }, count));
+    report("cTime::now", nsPerCall([&](size_t) {
+        benchmarkSink += cTime::now().nanoSeconds(); }, count));
+    report("cTime::toString(stCalendar, \"... %S.%f\")", nsPerCall([&](size_t i) {
+        calendar.second = (uint8_t)(i % 60);
+        benchmarkSink += cTime::toString(calendar, "%Y-%m-%d %H:%M:%S.%f").size(); }, count));
+    report("timeFormat::format (\"... %S.%f\")", nsPerCall([&](size_t i) {
+        calendar.second = (uint8_t)(i % 60);
+        benchmarkSink += timeFormat::format(buffer, calendar, fractionFormat); }, count));
+    report("cTime::set(std::string_view, \"... %S.%f %z\")", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::set(string_view(stamps[i & 4095]), "%Y-%m-%d %H:%M:%S.%f %z").nanoSeconds(); }, count));
+}
+
+/**
+ * @brief Clock sources of cTime::now(enClock).
+ */
+static void benchmarkClocks()
+{
+    const size_t count = 1000000;
+    const char* names[4] = {"cTime::now(enClock_realtime)", "cTime::now(enClock_coarse)", "cTime::now(enClock_tsc)", "cTime::now(enClock_ticker)"};
+
+    printf("------- Benchmark: clock sources ---------\n");
+    for (int clock = enClock_realtime; clock <= enClock_ticker; clock++)
+    {
+        int64_t error = cTime::clockError((enClock)clock);     // calibrates the TSC and starts the ticker
+        report(names[clock], nsPerCall([&](size_t) {
+            benchmarkSink += cTime::now((enClock)clock).nanoSeconds(); }, count));
+        printf("    error bound %lld ns\n", (long long)error);
+    }
+}
+
+/**
+ * @brief Current time strings: formatting cTime::now() against the strings cached by the ticker clock.
+ */
+static void benchmarkNowString()
+{
+    const size_t count = 1000000;
+    auto rfc3339 = LibCpp_TIMEFORMAT("%Y-%m-%dT%H:%M:%S%z");
+    char buffer[LibCpp_TIMESTRINGSIZE];
+    cTime::nowString(buffer);   // starts the ticker
+
+    printf("------- Benchmark: current time string ---------\n");
+    report("cTime::now().toString()", nsPerCall([&](size_t) {
+        benchmarkSink += cTime::now().toString().size(); }, count));
+    report("timeFormat::format(now, RFC 3339)", nsPerCall([&](size_t) {
+        benchmarkSink += timeFormat::format(buffer, cTime::now().calendar(cTime::asUTC), rfc3339); }, count));
+    report("cTime::nowString(buffer, enTimeString_GZC)", nsPerCall([&](size_t) {
+        benchmarkSink += cTime::nowString(buffer, enTimeString_GZC); }, count));
+    report("cTime::nowString(buffer, enTimeString_RFC3339)", nsPerCall([&](size_t) {
+        benchmarkSink += cTime::nowString(buffer, enTimeString_RFC3339); }, count));
+}
+
+/**
+ * @brief Memorized last day of cTime::unixToCalendar: sorted time stamps (a stream, about one per 5 seconds) against random ones.
+ */
+static void benchmarkDayCache()
+{
+    const size_t count = 1000000;
+    vector<time_t> randomSamples = timeSamples(4096);
+    vector<time_t> sortedSamples(count);
+    time_t value = calendarMath::unixTime(2024, 1, 1);
+    for (size_t n=0; n<count; n++)
+        sortedSamples[n] = value += (time_t)(n % 10);
+
+    printf("------- Benchmark: last day memoization ---------\n");
+    const char* names[2] = {"cTime::unixToCalendar (sorted)", "cTime::unixToCalendar (random)"};
+    for (int sorted=1; sorted>=0; sorted--)
+    {
+        uint64_t hits = cTime::dayCacheHits();
+        uint64_t misses = cTime::dayCacheMisses();
+        report(names[1 - sorted], nsPerCall([&](size_t i) {
+            benchmarkSink += cTime::unixToCalendar(sorted ? sortedSamples[i] : randomSamples[i & 4095]).day; }, count));
+        hits = cTime::dayCacheHits() - hits;
+        misses = cTime::dayCacheMisses() - misses;
+        printf("    hit rate %.1f %%\n", 100.0 * (double)hits / (double)(hits + misses));
+    }
+    report("calendarMath::unixToCalendar (sorted)", nsPerCall([&](size_t i) {
+        benchmarkSink += calendarMath::unixToCalendar(sortedSamples[i]).day; }, count));
+    report("calendarMath::unixToCalendar (random)", nsPerCall([&](size_t i) {
+        benchmarkSink += calendarMath::unixToCalendar(randomSamples[i & 4095]).day; }, count));
+}
+
+/**
+ * @brief Single calendar entries: full cTime::calendar() against the accessors and the lazy calendar view.
+ */
+static void benchmarkCalendarView()
+{
+    const size_t count = 1000000;
+    vector<time_t> samples = timeSamples(4096);
+    vector<cTime> times(samples.size());
+    for (size_t n=0; n<samples.size(); n++)
+        times[n] = cTime::set(samples[n]);
+
+    printf("------- Benchmark: single calendar entries ---------\n");
+    report("cTime::calendar().year", nsPerCall([&](size_t i) {
+        benchmarkSink += times[i & 4095].calendar().year; }, count));
+    report("cTime::year()", nsPerCall([&](size_t i) {
+        benchmarkSink += times[i & 4095].year(); }, count));
+    report("cTime::calendar().hour", nsPerCall([&](size_t i) {
+        benchmarkSink += times[i & 4095].calendar().hour; }, count));
+    report("cTime::hour()", nsPerCall([&](size_t i) {
+        benchmarkSink += times[i & 4095].hour(); }, count));
+    report("cTime::calendar(cTime::UTC).hour", nsPerCall([&](size_t i) {
+        benchmarkSink += times[i & 4095].calendar(cTime::UTC).hour; }, count));
+    report("cTime::hour(cTime::UTC)", nsPerCall([&](size_t i) {
+        benchmarkSink += times[i & 4095].hour(cTime::UTC); }, count));
+    report("cTime::view(): hour and dayInWeek", nsPerCall([&](size_t i) {
+        cCalendarView view = times[i & 4095].view();
+        benchmarkSink += view.hour() + view.dayInWeek(); }, count));
+}
+
+/**
+ * @brief 8 byte zoned time stamps: packing and unpacking cPackedTime against stCalendar and GZC strings.
+ */
+static void benchmarkPackedTime()
+{
+    const size_t count = 1000000;
+    vector<time_t> samples = timeSamples(4096);
+    vector<stCalendar> calendars(samples.size());
+    vector<string> stamps(samples.size());
+    vector<cPackedTime> packed(samples.size());
+    for (size_t n=0; n<samples.size(); n++)
+    {
+        calendars[n] = cTime::unixToCalendar(samples[n], stTimeZone{(int8_t)(n % 25 - 12), 0}, (int8_t)(n % 2));
+        stamps[n] = cTime::toString(calendars[n]);
+        packed[n] = cPackedTime::set(calendars[n]);
+    }
+
+    printf("------- Benchmark: packed zoned time stamps (%d bytes against %d and %d) ---------\n", (int)sizeof(cPackedTime), (int)sizeof(stCalendar), LibCpp_GZCLENGTH);
+    report("cPackedTime::set(stCalendar)", nsPerCall([&](size_t i) {
+        benchmarkSink += cPackedTime::set(calendars[i & 4095]).value(); }, count));
+    report("cPackedTime::calendar", nsPerCall([&](size_t i) {
+        benchmarkSink += packed[i & 4095].calendar().hour; }, count));
+    report("cPackedTime::set(GZC string)", nsPerCall([&](size_t i) {
+        benchmarkSink += cPackedTime::set(stamps[i & 4095]).value(); }, count));
+    report("cPackedTime::toString", nsPerCall([&](size_t i) {
+        benchmarkSink += packed[i & 4095].toString().size(); }, count));
+}
+
+/**
+ * @brief Zone carrying time: cZonedTime against cTime and the local zone.
+ */
+static void benchmarkZonedTime()
+{
+    const size_t count = 1000000;
+    vector<time_t> samples = timeSamples(4096);
+    vector<cTime> times(samples.size());
+    vector<cZonedTime> zonedTimes(samples.size());
+    for (size_t n=0; n<samples.size(); n++)
+    {
+        times[n] = cTime::set(samples[n]);
+        zonedTimes[n] = cZonedTime::set(times[n], stTimeZone{(int8_t)(n % 25 - 12), 0}, (int8_t)(n % 2));
+    }
+
+    printf("------- Benchmark: zone carrying time ---------\n");
+    report("cTime::calendar() (local zone)", nsPerCall([&](size_t i) {
+        benchmarkSink += times[i & 4095].calendar().hour; }, count));
+    report("cZonedTime::calendar() (kept zone)", nsPerCall([&](size_t i) {
+        benchmarkSink += zonedTimes[i & 4095].calendar().hour; }, count));
+    report("cTime::toString() (local zone)", nsPerCall([&](size_t i) {
+        benchmarkSink += times[i & 4095].toString().size(); }, count));
+    report("cZonedTime::toString() (kept zone)", nsPerCall([&](size_t i) {
+        benchmarkSink += zonedTimes[i & 4095].toString().size(); }, count));
+}
+
+/**
+ * @brief Whole cTime::toString() pipeline: the previous struct tm route against the direct calendar formatter.
+ */
+static void benchmarkFormatPipeline()
+{
+    const size_t count = 1000000;
+    vector<time_t> samples = timeSamples(4096);
+    vector<cTime> times(samples.size());
+    vector<stCalendar> calendars(samples.size());
+    for (size_t i=0; i<samples.size(); i++)
+    {
+        times[i] = cTime::set(samples[i], (int64_t)(i * 7919));
+        calendars[i] = cTime::unixToCalendar(samples[i], {1, 0}, (int8_t)(i & 1));
+    }
+    char buffer[64];
+
+    printf("------- Benchmark: calendar formatting pipeline ---------\n");
+    report("fromCalendar + LibOb_strftimeNano (via tm)", nsPerCall([&](size_t i) {
+        stTimeZone zone;
+        struct tm t = cTime::fromCalendar(calendars[i & 4095], &zone);
+        benchmarkSink += LibOb_strftimeNano(buffer, 64, LibOb_DEFAULTFORMAT, &t, &zone, nullptr, 0); }, count));
+    report("cTime::format(buffer, stCalendar)", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::format(buffer, 64, calendars[i & 4095]); }, count));
+    report("cTime::format(buffer, stCalendar, \"%H:%M:%3f\")", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::format(buffer, 64, calendars[i & 4095], "%H:%M:%3f"); }, count));
+    report("cTime::format(buffer, stCalendar, \"%A ... %Z\")", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::format(buffer, 64, calendars[i & 4095], "%A %Y-%m-%d %H:%M:%S %Z"); }, count));
+    report("cTime::toString(stCalendar)", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::toString(calendars[i & 4095]).size(); }, count));
+    report("cTime::format(buffer) (calendar + format)", nsPerCall([&](size_t i) {
+        benchmarkSink += times[i & 4095].format(buffer, 64); }, count));
+    report("cTime::toString() (calendar + format + string)", nsPerCall([&](size_t i) {
+        benchmarkSink += times[i & 4095].toString().size(); }, count));
+}
+
+/**
+ * @brief Compares cTime::set(string_view, format) with cTime::set(fromString()) for malformed strings.
+ * Each string gets one or two digits replaced, inserted or removed. Strings with a zone have to give
+ * the same unix time on both paths, whether the single pass scan accepts them or falls back to fromString().
+ * @param strings Correct calendar strings with a zone.
+ * @param format
+ * @return Number of malformed strings with a different unix time.
+ */
+static size_t scanMismatches(const vector<string>& strings, const string& format)
+{
+    size_t mismatches = 0;
+    uint64_t x = 2463534242ull;
+    for (size_t i=0; i<strings.size() * 64; i++)
+    {
+        string text = strings[i % strings.size()];
+        for (int k=0; k<1+(int)(i&1); k++)
+        {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            size_t position = (size_t)(x % (text.size() + 1));
+            char digit = (char)('0' + (x >> 32) % 10);
+            switch ((x >> 40) % 3)
+            {
+            case 0:  if (position < text.size()) text[position] = digit; break;
+            case 1:  text.insert(position, 1, digit); break;
+            default: if (position < text.size()) text.erase(position, 1); break;
+            }
+        }
+        if (cTime::set(string_view(text), format).time() != cTime::set(cTime::fromString(text, format)).time())
+            mismatches++;
+    }
+    return mismatches;
+}
+
+/**
+ * @brief Numeric calendar strings to unix time: struct tm and mktime against the single pass scan.
+ */
+static void benchmarkScan()
+{
+    const size_t count = 1000000;
+    const string localFormat = "%Y-%m-%d %H:%M:%S.%3f";
+    const string zoneFormat = "%Y-%m-%dT%H:%M:%S%z";
+    vector<time_t> samples = timeSamples(4096);
+    vector<string> localStrings(samples.size());
+    vector<string> zoneStrings(samples.size());
+    for (size_t i=0; i<samples.size(); i++)
+    {
+        localStrings[i] = cTime::set(samples[i]).toString(localFormat);
+        zoneStrings[i] = cTime::toString(cTime::unixToCalendar(samples[i], {(int8_t)(i % 25 - 12), 0}, -1), zoneFormat);
+    }
+    time_t unixTime = 0;
+    uint32_t nanoSeconds = 0;
+
+    printf("------- Benchmark: single pass string to unix time ---------\n");
+    report("fromString + set(stCalendar) (local, mktime)", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::set(cTime::fromString(localStrings[i & 4095], localFormat)).time(); }, count));
+    report("cTime::scan (local)", nsPerCall([&](size_t i) {
+        const string& text = localStrings[i & 4095];
+        cTime::scan(text.data(), text.size(), localFormat.c_str(), &unixTime, &nanoSeconds);
+        benchmarkSink += unixTime; }, count));
+    report("cTime::set(string_view, format) (local)", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::set(string_view(localStrings[i & 4095]), localFormat).time(); }, count));
+    report("fromString + set(stCalendar) (zone)", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::set(cTime::fromString(zoneStrings[i & 4095], zoneFormat)).time(); }, count));
+    report("cTime::scan (zone)", nsPerCall([&](size_t i) {
+        const string& text = zoneStrings[i & 4095];
+        cTime::scan(text.data(), text.size(), zoneFormat.c_str(), &unixTime);
+        benchmarkSink += unixTime; }, count));
+    report("cTime::set(string_view, format) (zone)", nsPerCall([&](size_t i) {
+        benchmarkSink += cTime::set(string_view(zoneStrings[i & 4095]), zoneFormat).time(); }, count));
+
+    vector<string> defaultStrings(samples.size());
+    for (size_t i=0; i<samples.size(); i++)
+        defaultStrings[i] = cTime::toString(cTime::unixToCalendar(samples[i], {(int8_t)(i % 25 - 12), 0}, (int8_t)(i % 3 - 1)));
+    printf("malformed strings differing from fromString: %zu (zone format), %zu (default format) of %zu each\n",
+           scanMismatches(zoneStrings, zoneFormat), scanMismatches(defaultStrings, ""), zoneStrings.size() * 64);
+}
+
+/**
+ * @brief Extracts the time stamps of a log with 1, 2, 4 and all hardware threads.
+ * @param log Opened log.
+ * @param format Format of the time stamps.
+ */
+static void reportLogTimes(cLogTimes& log, const string& format)
+{
+    unsigned int threadCounts[4] = {1, 2, 4, thread::hardware_concurrency()};
+    for (unsigned int threads : threadCounts)
+    {
+        if (threads == 0) continue;
+        stLogExtraction run = log.extract(format, threads);
+        char name[64];
+        snprintf(name, sizeof(name), "cLogTimes::extract (%u threads)", threads);
+        printf("%-48s %9.2f GB/s %12.0f lines/s (%llu lines, %llu invalid)\n", name, (double)run.bytes / run.seconds * 1e-9,
+               (double)run.lines / run.seconds, (unsigned long long)run.lines, (unsigned long long)run.invalidLines);
+    }
+}
+
+/**
+ * @brief Log file time stamp extraction of a generated file.
+ */
+static void benchmarkLogTimes()
+{
+    const size_t lines = 2000000;
+    vector<time_t> samples = timeSamples(4096);
+    string fileName = (filesystem::temp_directory_path() / "cTimeBenchmark.log").string();
+    FILE* file = fopen(fileName.c_str(), "wb");
+    if (!file) return;
+    for (size_t i=0; i<lines; i++)
+    {
+        string stamp = cTime::toString(cTime::unixToCalendar(samples[i & 4095], {1, 0}, (int8_t)(i & 1)));
+        fprintf(file, "%s | worker %zu: message of the log line\n", stamp.c_str(), i % 16);
+    }
+    fclose(file);
+
+    printf("------- Benchmark: log file time stamps ---------\n");
+    cLogTimes log;
+    if (log.open(fileName))
+        reportLogTimes(log, "");
+    log.close();
+    remove(fileName.c_str());
+}
+
+/**
+ * @brief Extracts the time stamps of a given log file and prints the results to stdout.
+ * @param fileName
+ * @param format Format of the time stamps, zero for the \ref GZC default format.
+ */
+void benchmarkLogFile(const char* fileName, const char* format)
+{
+    cLogTimes log;
+    printf("------- Benchmark: log file %s ---------\n", fileName);
+    if (!log.open(fileName))
+    {
+        printf("can not open %s\n", fileName);
+        return;
+    }
+    reportLogTimes(log, format ? format : "");
+    fflush(stdout);
+}
+
+/**
+ * @brief Runs all measurements and prints the results to stdout.
+ */
+void benchmark()
+{
+    benchmarkCalendar();
+    benchmarkLocalTimeZone();
+    benchmarkCalendarColumns();
+    benchmarkScanGZC();
+    benchmarkFormat();
+    benchmarkParseInPlace();
+    benchmarkCalendarMath();
+    benchmarkFormatProgram();
+    benchmarkCompileTimeFormat();
+    benchmarkZoneLookup();
+    benchmarkNames();
+    benchmarkLearningParser();
+    benchmarkLogTimes();
+    benchmarkZoneInfo();
+    benchmarkZoneRule();
+    benchmarkSubSecond();
+    benchmarkClocks();
+    benchmarkNowString();
+    benchmarkDayCache();
+    benchmarkCalendarView();
+    benchmarkPackedTime();
+    benchmarkZonedTime();
+    benchmarkFormatPipeline();
+    benchmarkScan();
+    fflush(stdout);
+}
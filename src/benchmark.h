@@ -0,0 +1,14 @@
+// utf-8 (ü)
+/**
+ * @file   benchmark.h
+ * @author Olaf Simon
+ * @brief  Run time measurements of the cTime and LibOb_strptime implementations.
+**/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+void benchmark();   ///< Runs all measurements and prints the results to stdout.
+void benchmarkLogFile(const char* fileName, const char* format);   ///< Extracts the time stamps of a log file with 1, 2, 4 and all hardware threads.
+
+#endif // BENCHMARK_H
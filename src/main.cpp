@@ -1,10 +1,22 @@
 #include "LibCpp/Time/cTime.h"
+#include "benchmark.h"
+
+#include <cstring>
 
 using namespace LibCpp;
 using namespace std;
 
-int main()
+int main(int argc, char* argv[])
 {
+    if (argc > 1 && strcmp(argv[1], "benchmark") == 0)
+    {
+        if (argc > 2)
+            benchmarkLogFile(argv[2], (argc > 3) ? argv[3] : nullptr);   // benchmark <log file> [format]
+        else
+            benchmark();
+        return 0;
+    }
+
     printf("------- Usage of strptime / strftime ---------\n");
     char timeStr[64];
     struct tm tp;
@@ -64,7 +76,7 @@ int main()
 
     printf("------- Usage of cTime: Mathematical operations ---------\n");
 
-    cTime timeChristmas = cTime::set(timeNow.calendar().year, 12, 24, 18, 0, 0);
+    cTime timeChristmas = cTime::set(timeNow.year(), 12, 24, 18, 0, 0);
     cTime timeWait = timeChristmas - timeNow;
     stDuration duration = timeWait.duration();
     printf("The wait time is: %s\n", cTime::toString(duration).c_str());
@@ -79,7 +91,7 @@ int main()
     printf("Wait time is      : %s\n", timeWait.toDurationString().c_str());
     // local time zone is: +01:00
     // UTC deviation is  : +02:00
-    // Calendar is       : 2023-09-20#20:17:38#DST#+01:00
+    // Calendar is       : 2023-09-20#17:17:38#DST#+01:00
     // Weekday is        : Wednesday
     // Wait time is      : D95#00:42:22
 